@@ -2,28 +2,161 @@
 #ifndef AOC_HPP_INCLUDED
 #define AOC_HPP_INCLUDED
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <semaphore>
+#include <stdexcept>
 #include <span>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#include <ankerl/unordered_dense.h>
+
 #include <flux.hpp>
 
 #include <fmt/format.h>
 #include <fmt/chrono.h>
 #include <fmt/ranges.h>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <link.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define AOC_HAS_IO_URING
+#endif
+#endif
+
+#include "aoc_alloc.hpp"
+
 namespace aoc {
 
 
 
+namespace detail {
+
+constexpr auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+
+// Reads the run of digits starting at str[pos], advancing pos past them. At
+// runtime, eight digits at a time are validated and converted using SWAR
+// tricks on a 64-bit word, rather than one at a time.
+constexpr auto read_digits(std::string_view str, std::size_t& pos) -> std::uint64_t
+{
+    std::uint64_t value = 0;
+
+    if !consteval {
+        if constexpr (std::endian::native == std::endian::little) {
+            constexpr std::uint64_t pow10[] = {
+                1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000,
+                100'000'000
+            };
+
+            while (pos + 8 <= str.size()) {
+                std::uint64_t word;
+                std::memcpy(&word, str.data() + pos, 8);
+
+                // A byte is a digit iff its high nibble is 3, both before
+                // and after adding 6. Carries can only corrupt bytes after
+                // the first non-digit, which we don't care about.
+                auto const nibbles =
+                    (word & 0xF0F0F0F0F0F0F0F0) |
+                    (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4);
+                auto const mismatch = nibbles ^ 0x3333333333333333;
+                auto const n_digits = static_cast<std::size_t>(std::countr_zero(mismatch) / 8);
+
+                if (n_digits == 0) {
+                    return value;
+                }
+
+                // Shift the digits to the top of the word, so that the
+                // (zeroed) bytes below them act as leading zeros
+                auto chunk = (word - 0x3030303030303030) << (8 * (8 - n_digits));
+                chunk = ((chunk & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+                chunk = ((chunk & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+                chunk = ((chunk & 0x0000FFFF0000FFFF) * 42949672960001) >> 32;
+
+                value = value * pow10[n_digits] + chunk;
+                pos += n_digits;
+
+                if (n_digits < 8) {
+                    return value;
+                }
+            }
+        }
+    }
+
+    for (; pos < str.size() && is_digit(str[pos]); ++pos) {
+        value = 10 * value + static_cast<std::uint64_t>(str[pos] - '0');
+    }
+    return value;
+}
+
+// try_parse() for contiguous input; behaves identically to the general case
+template <std::integral I>
+constexpr auto try_parse_contiguous(std::string_view str) -> std::optional<I>
+{
+    auto pos = str.find_first_not_of(" \f\n\r\t\v");
+    if (pos == std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    bool const negative = str[pos] == '-';
+    if (negative || str[pos] == '+') {
+        ++pos;
+    }
+
+    auto const start = pos;
+    auto const value = static_cast<I>(read_digits(str, pos));
+    if (pos == start) {
+        return std::nullopt;
+    }
+    return negative ? static_cast<I>(0 - value) : value;
+}
+
+}
+
 // This function is not great, but nor are the alternatives:
 //  * std::from_chars - not constexpr, requires contiguous input
 //  * std::atoi - same
@@ -34,6 +167,12 @@ namespace aoc {
 template <std::integral I>
 const auto try_parse = [](flux::sequence auto&& f) -> std::optional<I> {
 
+    // Fast path for string_views and strings, which is most of our uses
+    using F = std::remove_cvref_t<decltype(f)>;
+    if constexpr (std::same_as<F, std::string_view> || std::same_as<F, std::string>) {
+        return detail::try_parse_contiguous<I>(f);
+    }
+
     //constexpr auto is_space = flow::pred::in(' ', '\f', '\n', '\r', '\t', '\v');
     //constexpr auto is_digit = flow::pred::geq('0') && flow::pred::leq('9');
     constexpr auto is_space = [](char c) {
@@ -85,33 +224,2876 @@ constexpr auto parse = [](flux::sequence auto&& seq) -> I
     return try_parse<I>(FLUX_FWD(seq)).value();
 };
 
-template <typename T>
-constexpr auto vector_from_file = [](char const* path)
+// The start offset of every line in a text, found with a single scan for
+// newlines using SSE2/AVX2 where available. Lines are split exactly as
+// flux::split_string(text, '\n') would split them (so a trailing newline
+// gives a final empty line), but can then be accessed randomly, e.g. to hand
+// out ranges of lines to different threads.
+class line_index {
+public:
+    constexpr explicit line_index(std::string_view text)
+        : text_(text)
+    {
+        starts_.push_back(0);
+        if consteval {
+            scan_from(0);
+        } else {
+            scan();
+        }
+    }
+
+    constexpr auto size() const -> std::size_t { return starts_.size(); }
+
+    constexpr auto operator[](std::size_t idx) const -> std::string_view
+    {
+        auto const start = starts_[idx];
+        auto const end = idx + 1 < starts_.size() ? starts_[idx + 1] - 1 : text_.size();
+        return text_.substr(start, end - start);
+    }
+
+    // A random-access sequence of the lines, which refers to this index
+    constexpr auto lines() const -> flux::sequence auto
+    {
+        return flux::ints(0, size()).map([this](auto idx) { return (*this)[idx]; });
+    }
+
+private:
+    // Plain scan from pos to the end; find() ends up calling memchr() at
+    // runtime, so this is still fairly quick
+    constexpr void scan_from(std::size_t pos)
+    {
+        while ((pos = text_.find('\n', pos)) != std::string_view::npos) {
+            starts_.push_back(++pos);
+        }
+    }
+
+    void scan()
+    {
+        [[maybe_unused]] char const* const data = text_.data();
+        std::size_t pos = 0;
+
+        [[maybe_unused]] auto push_matches = [&](std::uint32_t mask) {
+            while (mask != 0) {
+                starts_.push_back(pos + std::countr_zero(mask) + 1);
+                mask &= mask - 1;
+            }
+        };
+
+#if defined(__AVX2__)
+        auto const nl32 = _mm256_set1_epi8('\n');
+        for (; pos + 32 <= text_.size(); pos += 32) {
+            auto chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + pos));
+            push_matches(static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, nl32))));
+        }
+#endif
+#if defined(__SSE2__)
+        auto const nl16 = _mm_set1_epi8('\n');
+        for (; pos + 16 <= text_.size(); pos += 16) {
+            auto chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + pos));
+            push_matches(static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nl16))));
+        }
+#endif
+        scan_from(pos);
+    }
+
+    std::string_view text_;
+    std::vector<std::size_t> starts_;
+};
+
+// Parses every integer in str in a single pass, writing them to out and
+// returning the updated output iterator. Integers are runs of digits,
+// optionally preceded by '-'; everything else is treated as a separator.
+template <std::integral I>
+constexpr auto parse_all = []<std::output_iterator<I> Out>(std::string_view str, Out out) -> Out
 {
-    std::ifstream file(path);
-    return flux::from_istream<T>(file).template to<std::vector<T>>();
+    std::size_t pos = 0;
+    while (pos < str.size()) {
+        char const c = str[pos];
+        bool const negative =
+            c == '-' && pos + 1 < str.size() && detail::is_digit(str[pos + 1]);
+
+        if (negative || detail::is_digit(c)) {
+            pos += negative;
+            auto const value = static_cast<I>(detail::read_digits(str, pos));
+            *out++ = negative ? static_cast<I>(0 - value) : value;
+        } else {
+            ++pos;
+        }
+    }
+    return out;
 };
 
-constexpr auto string_from_file = [](const char* path)
+// A row-major 2D grid surrounded by a border of sentinel cells, so that
+// looking at a cell's neighbours never needs a bounds check -- stepping off the
+// edge just finds the border value. Cells are addressed by their index in the
+// padded storage, and adding north(), east() etc. to an index gives the index
+// of the neighbouring cell.
+template <typename T>
+class grid2d {
+public:
+    using value_type = T;
+    using index_type = std::int64_t;
+
+    grid2d() = default;
+
+    constexpr grid2d(index_type width, index_type height, T border, index_type pad = 1)
+        : width_(width),
+          height_(height),
+          pad_(pad),
+          stride_(width + 2 * pad),
+          cells_(static_cast<std::size_t>(stride_ * (height + 2 * pad)), border)
+    {}
+
+    // Reads a grid from lines of text, converting each character with fn.
+    // Every line must be the same length.
+    template <typename Fn = std::identity>
+    static constexpr auto from_text(std::string_view text, T border, Fn fn = {},
+                                    index_type pad = 1) -> grid2d
+    {
+        while (text.ends_with('\n')) {
+            text.remove_suffix(1);
+        }
+        auto const width = static_cast<index_type>(std::min(text.find('\n'), text.size()));
+        auto const height = text.empty() ? 0 : 1 + static_cast<index_type>(flux::count_eq(text, '\n'));
+
+        grid2d grid(width, height, border, pad);
+        for (index_type y = 0; y < height; ++y) {
+            auto const line = text.substr(0, text.find('\n'));
+            if (static_cast<index_type>(line.size()) != width) {
+                throw std::runtime_error("Grid lines have different lengths");
+            }
+            for (index_type x = 0; x < width; ++x) {
+                grid.cell(x, y) = static_cast<T>(fn(line[x]));
+            }
+            text.remove_prefix(std::min(line.size() + 1, text.size()));
+        }
+        return grid;
+    }
+
+    constexpr auto width() const -> index_type { return width_; }
+    constexpr auto height() const -> index_type { return height_; }
+
+    constexpr auto index(index_type x, index_type y) const -> index_type
+    {
+        return (y + pad_) * stride_ + x + pad_;
+    }
+
+    constexpr auto x_of(index_type idx) const -> index_type { return idx % stride_ - pad_; }
+    constexpr auto y_of(index_type idx) const -> index_type { return idx / stride_ - pad_; }
+
+    constexpr auto in_bounds(index_type x, index_type y) const -> bool
+    {
+        return x >= 0 && x < width_ && y >= 0 && y < height_;
+    }
+
+    // Unchecked access by index. Indices up to pad steps outside the grid are
+    // fine, and give the border value.
+    constexpr auto operator[](index_type idx) -> T& { return cells_[idx]; }
+    constexpr auto operator[](index_type idx) const -> T const& { return cells_[idx]; }
+
+    constexpr auto cell(index_type x, index_type y) -> T& { return cells_[index(x, y)]; }
+    constexpr auto cell(index_type x, index_type y) const -> T const& { return cells_[index(x, y)]; }
+
+    // Offsets from an index to its neighbours
+    constexpr auto north() const -> index_type { return -stride_; }
+    constexpr auto east() const -> index_type { return 1; }
+    constexpr auto south() const -> index_type { return stride_; }
+    constexpr auto west() const -> index_type { return -1; }
+
+    // The same, in clockwise order starting from north
+    constexpr auto offsets() const -> std::array<index_type, 4>
+    {
+        return {north(), east(), south(), west()};
+    }
+
+    // The index of the first cell holding value, or -1 if there isn't one
+    constexpr auto find(T const& value) const -> index_type
+    {
+        auto const iter = std::ranges::find(cells_, value);
+        return iter == cells_.end() ? -1 : static_cast<index_type>(iter - cells_.begin());
+    }
+
+    // The indices of the cells inside the border, row by row. The sequence
+    // refers to this grid.
+    constexpr auto indices() const -> flux::sequence auto
+    {
+        return flux::ints(0, width_ * height_).map([this](index_type i) {
+            return index(i % width_, i / width_);
+        });
+    }
+
+    // The underlying storage, including the border
+    constexpr auto data() const -> std::vector<T> const& { return cells_; }
+
+    friend constexpr auto operator==(grid2d const&, grid2d const&) -> bool = default;
+
+private:
+    index_type width_ = 0;
+    index_type height_ = 0;
+    index_type pad_ = 0;
+    index_type stride_ = 0;
+    std::vector<T> cells_;
+};
+
+// A 2D grid of bits, stored as rows of 64-bit words so that whole rows can be
+// shifted, combined and counted 64 cells at a time. Cell x of a row is bit
+// x % 64 of word x / 64, and bits past the end of a row are always zero.
+class bitgrid {
+public:
+    using word_type = std::uint64_t;
+    using index_type = std::int64_t;
+
+    static constexpr index_type word_bits = 64;
+
+    bitgrid() = default;
+
+    constexpr bitgrid(index_type width, index_type height)
+        : width_(width),
+          height_(height),
+          row_words_((width + word_bits - 1) / word_bits),
+          words_(static_cast<std::size_t>(row_words_ * height), 0)
+    {}
+
+    // A grid with a bit set for each occurrence of c in lines of text. Every
+    // line must be the same length.
+    static constexpr auto from_text(std::string_view text, char c) -> bitgrid
+    {
+        while (text.ends_with('\n')) {
+            text.remove_suffix(1);
+        }
+        auto const width = static_cast<index_type>(std::min(text.find('\n'), text.size()));
+        auto const height = text.empty() ? 0 : 1 + static_cast<index_type>(flux::count_eq(text, '\n'));
+
+        bitgrid grid(width, height);
+        for (index_type y = 0; y < height; ++y) {
+            auto const line = text.substr(0, text.find('\n'));
+            if (static_cast<index_type>(line.size()) != width) {
+                throw std::runtime_error("Grid lines have different lengths");
+            }
+            for (index_type x = 0; x < width; ++x) {
+                if (line[x] == c) {
+                    grid.set(x, y);
+                }
+            }
+            text.remove_prefix(std::min(line.size() + 1, text.size()));
+        }
+        return grid;
+    }
+
+    constexpr auto width() const -> index_type { return width_; }
+    constexpr auto height() const -> index_type { return height_; }
+
+    constexpr auto test(index_type x, index_type y) const -> bool
+    {
+        return (words_[y * row_words_ + x / word_bits] >> (x % word_bits)) & 1;
+    }
+
+    constexpr void set(index_type x, index_type y, bool value = true)
+    {
+        auto& word = words_[y * row_words_ + x / word_bits];
+        auto const bit = word_type{1} << (x % word_bits);
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    constexpr auto row(index_type y) const -> std::span<word_type const>
+    {
+        return std::span(words_).subspan(y * row_words_, row_words_);
+    }
+
+    // All the rows, one after the other
+    constexpr auto words() const -> std::span<word_type const> { return words_; }
+
+    constexpr auto row_count(index_type y) const -> index_type
+    {
+        index_type n = 0;
+        for (word_type w : row(y)) {
+            n += std::popcount(w);
+        }
+        return n;
+    }
+
+    constexpr auto count() const -> index_type
+    {
+        index_type n = 0;
+        for (word_type w : words_) {
+            n += std::popcount(w);
+        }
+        return n;
+    }
+
+    constexpr auto any() const -> bool
+    {
+        return std::ranges::any_of(words_, [](word_type w) { return w != 0; });
+    }
+
+    constexpr auto operator&=(bitgrid const& other) -> bitgrid&
+    {
+        for (std::size_t i = 0; i < words_.size(); ++i) {
+            words_[i] &= other.words_[i];
+        }
+        return *this;
+    }
+
+    constexpr auto operator|=(bitgrid const& other) -> bitgrid&
+    {
+        for (std::size_t i = 0; i < words_.size(); ++i) {
+            words_[i] |= other.words_[i];
+        }
+        return *this;
+    }
+
+    constexpr auto operator^=(bitgrid const& other) -> bitgrid&
+    {
+        for (std::size_t i = 0; i < words_.size(); ++i) {
+            words_[i] ^= other.words_[i];
+        }
+        return *this;
+    }
+
+    // Clears every bit which is set in other
+    constexpr auto and_not(bitgrid const& other) -> bitgrid&
+    {
+        for (std::size_t i = 0; i < words_.size(); ++i) {
+            words_[i] &= ~other.words_[i];
+        }
+        return *this;
+    }
+
+    constexpr auto flip() -> bitgrid&
+    {
+        for (word_type& w : words_) {
+            w = ~w;
+        }
+        clear_row_ends();
+        return *this;
+    }
+
+    // Shifts move every cell one step in the given direction. Cells which fall
+    // off the edge are lost, and the cells left behind are cleared.
+    constexpr auto shift_north() -> bitgrid&
+    {
+        if (height_ > 0) {
+            std::ranges::copy(words_.begin() + row_words_, words_.end(), words_.begin());
+            std::ranges::fill(words_.end() - row_words_, words_.end(), 0);
+        }
+        return *this;
+    }
+
+    constexpr auto shift_south() -> bitgrid&
+    {
+        if (height_ > 0) {
+            std::ranges::copy_backward(words_.begin(), words_.end() - row_words_, words_.end());
+            std::ranges::fill(words_.begin(), words_.begin() + row_words_, 0);
+        }
+        return *this;
+    }
+
+    constexpr auto shift_east() -> bitgrid&
+    {
+        for (index_type y = 0; row_words_ > 0 && y < height_; ++y) {
+            word_type* const r = words_.data() + y * row_words_;
+            for (index_type i = row_words_ - 1; i > 0; --i) {
+                r[i] = (r[i] << 1) | (r[i - 1] >> (word_bits - 1));
+            }
+            r[0] <<= 1;
+        }
+        clear_row_ends();
+        return *this;
+    }
+
+    constexpr auto shift_west() -> bitgrid&
+    {
+        for (index_type y = 0; row_words_ > 0 && y < height_; ++y) {
+            word_type* const r = words_.data() + y * row_words_;
+            for (index_type i = 0; i < row_words_ - 1; ++i) {
+                r[i] = (r[i] >> 1) | (r[i + 1] << (word_bits - 1));
+            }
+            r[row_words_ - 1] >>= 1;
+        }
+        return *this;
+    }
+
+    // Swaps rows and columns, 64x64 bits at a time
+    constexpr auto transposed() const -> bitgrid
+    {
+        bitgrid out(height_, width_);
+        std::array<word_type, word_bits> block{};
+
+        for (index_type by = 0; by < height_; by += word_bits) {
+            for (index_type bx = 0; bx < row_words_; ++bx) {
+                for (index_type i = 0; i < word_bits; ++i) {
+                    block[i] = by + i < height_ ? words_[(by + i) * row_words_ + bx] : 0;
+                }
+                transpose_block(block);
+                for (index_type i = 0; i < word_bits && bx * word_bits + i < width_; ++i) {
+                    out.words_[(bx * word_bits + i) * out.row_words_ + by / word_bits] = block[i];
+                }
+            }
+        }
+        return out;
+    }
+
+    friend constexpr auto operator&(bitgrid lhs, bitgrid const& rhs) -> bitgrid { return lhs &= rhs; }
+    friend constexpr auto operator|(bitgrid lhs, bitgrid const& rhs) -> bitgrid { return lhs |= rhs; }
+    friend constexpr auto operator^(bitgrid lhs, bitgrid const& rhs) -> bitgrid { return lhs ^= rhs; }
+
+    friend constexpr auto operator==(bitgrid const&, bitgrid const&) -> bool = default;
+
+private:
+    constexpr void clear_row_ends()
+    {
+        if (auto const tail = width_ % word_bits; tail != 0) {
+            auto const mask = (word_type{1} << tail) - 1;
+            for (index_type y = 0; y < height_; ++y) {
+                words_[(y + 1) * row_words_ - 1] &= mask;
+            }
+        }
+    }
+
+    // Transposes a 64x64 block of bits in place by swapping successively
+    // smaller sub-blocks (Hacker's Delight, section 7-3)
+    static constexpr void transpose_block(std::array<word_type, word_bits>& a)
+    {
+        word_type mask = 0x0000'0000'FFFF'FFFF;
+        for (index_type j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+            for (index_type k = 0; k < word_bits; k = ((k | j) + 1) & ~j) {
+                word_type const t = ((a[k] >> j) ^ a[k | j]) & mask;
+                a[k] ^= t << j;
+                a[k | j] ^= t;
+            }
+        }
+    }
+
+    index_type width_ = 0;
+    index_type height_ = 0;
+    index_type row_words_ = 0;
+    std::vector<word_type> words_;
+};
+
+// Shortest paths. A graph provides its node and distance types, calls
+// fn(node, weight) for each edge leaving a node, and says which nodes are
+// targets; the search stops at the first target reached. Graphs whose nodes
+// are dense integer IDs less than node_count() use flat arrays rather than a
+// map for the distances, and if they also have integer weights no greater
+// than max_weight, Dial's algorithm replaces the binary heap with a circular
+// array of buckets, one per distance.
+template <typename G>
+concept Graph =
+    std::regular<typename G::node_type> &&
+    std::regular<typename G::distance_type> &&
+    std::totally_ordered<typename G::distance_type> &&
+    requires (G const& g, typename G::node_type n) {
+        g.for_each_neighbour(n, [](typename G::node_type, typename G::distance_type) {});
+        { g.should_exit(n) } -> std::same_as<bool>;
+    };
+
+template <typename G>
+concept DenseGraph =
+    Graph<G> &&
+    std::integral<typename G::node_type> &&
+    requires (G const& g) {
+        { g.node_count() } -> std::convertible_to<std::int64_t>;
+    };
+
+template <typename G>
+concept BucketGraph =
+    DenseGraph<G> &&
+    std::integral<typename G::distance_type> &&
+    requires {
+        { G::max_weight } -> std::convertible_to<typename G::distance_type>;
+    };
+
+namespace detail {
+
+template <BucketGraph G>
+auto dial(G const& graph, std::initializer_list<typename G::node_type> starts)
+    -> std::optional<typename G::distance_type>
 {
-    std::ifstream file(path);
-    return flux::from_istreambuf(file).template to<std::string>();
+    using node_t = G::node_type;
+    using dist_t = G::distance_type;
+
+    // Every node waiting in the queue is at most max_weight further away than
+    // the one we're visiting, so this many buckets never overlap
+    auto const n_buckets = static_cast<std::size_t>(G::max_weight) + 1;
+
+    // These keep their memory between searches on the same thread (of which
+    // there are many in --batch mode), so it only has to be allocated once.
+    // This means a graph mustn't start another search of its own type from
+    // inside for_each_neighbour().
+    thread_local std::vector<std::vector<node_t>> buckets;
+    thread_local std::vector<dist_t> dists;
+    buckets.resize(n_buckets);
+    for (auto& bucket : buckets) {
+        bucket.clear(); // an earlier search may have exited early
+    }
+    dists.assign(static_cast<std::size_t>(graph.node_count()),
+                 std::numeric_limits<dist_t>::max());
+    std::int64_t queued = 0;
+
+    for (node_t start : starts) {
+        dists[start] = dist_t{};
+        buckets[0].push_back(start);
+        ++queued;
+    }
+
+    for (dist_t dist = 0; queued > 0; ++dist) {
+        auto& bucket = buckets[static_cast<std::size_t>(dist) % n_buckets];
+        while (!bucket.empty()) {
+            node_t const current = bucket.back();
+            bucket.pop_back();
+            --queued;
+
+            if (dists[current] != dist) {
+                continue; // we've since found a shorter path
+            }
+            if (graph.should_exit(current)) {
+                return dist;
+            }
+
+            graph.for_each_neighbour(current, [&](node_t next, dist_t weight) {
+                dist_t const new_dist = dist + weight;
+                if (new_dist < dists[next]) {
+                    dists[next] = new_dist;
+                    buckets[static_cast<std::size_t>(new_dist) % n_buckets].push_back(next);
+                    ++queued;
+                }
+            });
+        }
+    }
+
+    return std::nullopt;
+}
+
+}
+
+constexpr auto dijkstra =
+[]<Graph G>(G const& graph, std::initializer_list<typename G::node_type> starts)
+    -> std::optional<typename G::distance_type>
+{
+    using node_t = G::node_type;
+    using dist_t = G::distance_type;
+
+    if constexpr (BucketGraph<G>) {
+        return detail::dial(graph, starts);
+    } else {
+        using entry_t = std::pair<dist_t, node_t>;
+        std::priority_queue<entry_t, std::vector<entry_t>, std::greater<>> queue;
+
+        auto dists = [&] {
+            if constexpr (DenseGraph<G>) {
+                return std::vector<std::optional<dist_t>>(
+                    static_cast<std::size_t>(graph.node_count()));
+            } else {
+                return std::map<node_t, std::optional<dist_t>>{};
+            }
+        }();
+
+        for (node_t const& start : starts) {
+            dists[start] = dist_t{};
+            queue.push({dist_t{}, start});
+        }
+
+        while (!queue.empty()) {
+            auto const [dist, current] = queue.top();
+            queue.pop();
+
+            if (dist != *dists[current]) {
+                continue; // we've since found a shorter path
+            }
+            if (graph.should_exit(current)) {
+                return dist;
+            }
+
+            graph.for_each_neighbour(current, [&](node_t const& next, dist_t weight) {
+                dist_t const new_dist = dist + weight;
+                if (auto& d = dists[next]; !d.has_value() || new_dist < *d) {
+                    d = new_dist;
+                    queue.push({new_dist, next});
+                }
+            });
+        }
+
+        return std::nullopt;
+    }
 };
 
-struct timer {
-    using clock = std::chrono::high_resolution_clock;
+namespace detail {
 
-    template <typename D = std::chrono::microseconds>
-    auto elapsed() const -> D {
-        return std::chrono::duration_cast<D>(clock::now() - start_);
+template <typename T>
+concept tuple_like = requires { std::tuple_size<T>::value; };
+
+template <typename T>
+concept has_hash_members = requires(T const& t) { hash_members(t); };
+
+}
+
+// Hashes a std::tuple, std::pair or std::array by combining the hashes of its
+// elements, so that compound keys can be used in ankerl::unordered_dense maps
+// (which mix the result further themselves). Other types, such as aggregates,
+// can be hashed the same way by providing a hash_members(t) function (found by
+// ADL) which returns a tuple of their members, e.g. using std::tie().
+struct tuple_hash {
+    template <typename T>
+    auto operator()(T const& t) const noexcept -> std::uint64_t
+    {
+        if constexpr (detail::has_hash_members<T>) {
+            return (*this)(hash_members(t));
+        } else if constexpr (detail::tuple_like<T>) {
+            return std::apply([this](auto const&... elems) {
+                std::uint64_t h = 0;
+                ((h = std::rotl(h, 21) ^ (*this)(elems)), ...);
+                return h;
+            }, t);
+        } else {
+            return ankerl::unordered_dense::hash<T>{}(t);
+        }
     }
+};
 
-    void reset() { start_ = clock::now(); }
+// A cache of the results of some function of a compound key, such as the state
+// of a recursive search. Keys are hashed with tuple_hash, so an aggregate key
+// needs a hash_members() function (and an operator==).
+template <typename Key, typename Value>
+class memo {
+public:
+    // The value stored for key, or nullptr if there isn't one
+    auto find(Key const& key) const -> Value const*
+    {
+        auto const iter = map_.find(key);
+        return iter != map_.end() ? &iter->second : nullptr;
+    }
+
+    auto insert(Key const& key, Value value) -> Value const&
+    {
+        return map_.insert_or_assign(key, std::move(value)).first->second;
+    }
+
+    auto size() const -> std::size_t { return map_.size(); }
+
+    void clear() { map_.clear(); }
 
 private:
-    typename clock::time_point start_ = clock::now();
+    ankerl::unordered_dense::map<Key, Value, tuple_hash> map_;
 };
 
+// As memo, for keys of N integers whose bounds are known up front: the values
+// live in a flat array indexed by the key, so there's no hashing at all. This
+// is only a good fit when a decent fraction of the keys will be used.
+template <typename Value, std::size_t N>
+class dense_memo {
+public:
+    using key_type = std::array<std::int64_t, N>;
+
+    // Each component of a key k must satisfy 0 <= k[i] < bounds[i]
+    constexpr explicit dense_memo(key_type const& bounds)
+        : bounds_(bounds)
+    {
+        std::int64_t size = 1;
+        for (std::int64_t bound : bounds) {
+            size *= bound;
+        }
+        values_.resize(static_cast<std::size_t>(size));
+    }
+
+    constexpr auto find(key_type const& key) const -> Value const*
+    {
+        auto const& slot = values_[offset(key)];
+        return slot.has_value() ? &*slot : nullptr;
+    }
+
+    constexpr auto insert(key_type const& key, Value value) -> Value const&
+    {
+        return values_[offset(key)].emplace(std::move(value));
+    }
+
+private:
+    constexpr auto offset(key_type const& key) const -> std::size_t
+    {
+        std::int64_t off = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            assert(key[i] >= 0 && key[i] < bounds_[i]);
+            off = off * bounds_[i] + key[i];
+        }
+        return static_cast<std::size_t>(off);
+    }
+
+    key_type bounds_;
+    std::vector<std::optional<Value>> values_;
+};
+
+static_assert([] {
+    dense_memo<int, 3> m({2, 3, 4});
+    bool ok = m.find({1, 2, 3}) == nullptr;
+    m.insert({1, 2, 3}, 42);
+    m.insert({0, 0, 0}, 7);
+    m.insert({1, 0, 0}, 8);
+    ok = ok && *m.find({1, 2, 3}) == 42 && *m.find({0, 0, 0}) == 7 && *m.find({1, 0, 0}) == 8;
+    ok = ok && m.find({0, 2, 3}) == nullptr && m.find({1, 1, 3}) == nullptr;
+    return ok && m.insert({1, 2, 3}, 43) == 43;
+}());
+
+// Somewhere for parsers which build lots of small containers to put them. The
+// memory comes from a few large blocks, handed out in order and never reused,
+// which are all freed together when the arena goes away -- so neither building
+// nor tearing down the parsed input costs an allocation per container.
+//
+// Containers using arena.allocator<T>() must not outlive the arena, so declare
+// it first in the struct which holds them. It can be moved (the blocks stay
+// put, and a moved-from arena can't be used again) but not assigned to, which
+// would free memory the containers still use.
+// Allocating isn't thread-safe, so fill the arena from one thread at a time.
+class arena {
+public:
+    explicit arena(std::size_t initial_size = 4096)
+        : resource_(std::make_unique<std::pmr::monotonic_buffer_resource>(
+                        std::max<std::size_t>(initial_size, 64)))
+    {}
+
+    arena(arena&&) noexcept = default;
+    arena& operator=(arena&&) = delete;
+
+    auto resource() const -> std::pmr::memory_resource*
+    {
+        assert(resource_ != nullptr && "arena used after being moved from");
+        return resource_.get();
+    }
+
+    template <typename T = std::byte>
+    auto allocator() const -> std::pmr::polymorphic_allocator<T>
+    {
+        return resource();
+    }
+
+private:
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> resource_;
+};
+
+// Hashes anything convertible to std::string_view, so that maps keyed by
+// std::string or std::pmr::string can be searched with a string_view (along
+// with std::equal_to<>) without making a string first
+struct string_hash {
+    using is_transparent = void;
+    using is_avalanching = void;
+
+    auto operator()(std::string_view str) const noexcept -> std::uint64_t
+    {
+        return ankerl::unordered_dense::hash<std::string_view>{}(str);
+    }
+};
+
+// Numbers identifiers 0, 1, 2... in the order they are first seen, so that a
+// parser can turn names into indices once and the solver can use flat arrays
+// rather than hashing and copying strings in its inner loops
+class interner {
+public:
+    using id_type = std::uint32_t;
+
+    // The ID of str, giving it the next one if it hasn't been seen before
+    auto intern(std::string_view str) -> id_type
+    {
+        auto const iter = ids_.find(str);
+        if (iter != ids_.end()) {
+            return iter->second;
+        }
+        auto const id = size();
+        ids_.emplace(std::string(str), id);
+        names_.emplace_back(str);
+        return id;
+    }
+
+    auto find(std::string_view str) const -> std::optional<id_type>
+    {
+        auto const iter = ids_.find(str);
+        return iter != ids_.end() ? std::optional(iter->second) : std::nullopt;
+    }
+
+    auto name(id_type id) const -> std::string const& { return names_.at(id); }
+
+    auto size() const -> id_type { return static_cast<id_type>(names_.size()); }
+
+private:
+    ankerl::unordered_dense::map<std::string, id_type, string_hash, std::equal_to<>> ids_;
+    std::vector<std::string> names_;
+};
+
+struct cycle_info {
+    std::int64_t tail;   // the number of steps before the cycle is entered
+    std::int64_t period;
+};
+
+// Finds the cycle which repeatedly calling step(state) eventually falls into.
+// Only a 64-bit fingerprint of each state, from hash(state), is remembered
+// rather than the states themselves. When a fingerprint repeats, the earlier
+// state is recreated by stepping a copy of the starting state, and the two are
+// compared in full; states whose fingerprints collided are remembered
+// separately, so that a collision can't hide the real repeat later on. On
+// return, state has been stepped exactly one period past tail.
+constexpr auto find_cycle =
+[]<std::equality_comparable State>(State& state, auto step, auto hash) -> cycle_info
+{
+    State const start = state;
+    auto const state_at = [&](std::int64_t n) {
+        State s = start;
+        for (std::int64_t j = 0; j < n; ++j) {
+            step(s);
+        }
+        return s;
+    };
+
+    // The first step with each fingerprint, and then any later steps with
+    // the same fingerprint but a different state
+    ankerl::unordered_dense::map<std::uint64_t, std::int64_t> seen;
+    std::vector<std::pair<std::uint64_t, std::int64_t>> collisions;
+    seen.try_emplace(static_cast<std::uint64_t>(hash(state)), 0);
+
+    for (std::int64_t i = 1; ; ++i) {
+        step(state);
+        auto const fp = static_cast<std::uint64_t>(hash(state));
+        auto const [iter, inserted] = seen.try_emplace(fp, i);
+        if (inserted) {
+            continue;
+        }
+
+        if (state_at(iter->second) == state) {
+            return {.tail = iter->second, .period = i - iter->second};
+        }
+        for (auto const& [other_fp, j] : collisions) {
+            if (other_fp == fp && state_at(j) == state) {
+                return {.tail = j, .period = i - j};
+            }
+        }
+        collisions.emplace_back(fp, i);
+    }
+};
+
+template <typename T>
+constexpr auto vector_from_file = [](char const* path)
+{
+    std::ifstream file(path);
+    return flux::from_istream<T>(file).template to<std::vector<T>>();
+};
+
+constexpr auto string_from_file = [](const char* path)
+{
+    std::ifstream file(path);
+    return flux::from_istreambuf(file).template to<std::string>();
+};
+
+struct timer {
+    using clock = std::chrono::high_resolution_clock;
+
+    template <typename D = std::chrono::microseconds>
+    auto elapsed() const -> D {
+        return std::chrono::duration_cast<D>(clock::now() - start_);
+    }
+
+    void reset() { start_ = clock::now(); }
+
+private:
+    typename clock::time_point start_ = clock::now();
+};
+
+// Hardware performance counters for a region of code, read using Linux's
+// perf_event_open() for the calling thread only. Any counters which can't be
+// opened (no permission, unsupported in a VM, not Linux...) are left empty, so
+// at worst this degrades to just timing the region.
+struct perf_counts {
+    std::chrono::nanoseconds elapsed{};
+    std::optional<std::int64_t> cycles;
+    std::optional<std::int64_t> instructions;
+    std::optional<std::int64_t> l1d_misses;
+    std::optional<std::int64_t> llc_misses;
+    std::optional<std::int64_t> branch_misses;
+};
+
+class perf_scope {
+public:
+    perf_scope()
+    {
+#ifdef __linux__
+        constexpr std::uint64_t l1d_read_miss =
+            PERF_COUNT_HW_CACHE_L1D |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        fds_ = {open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES),
+                open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS),
+                open_counter(PERF_TYPE_HW_CACHE, l1d_read_miss),
+                open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES),
+                open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES)};
+#endif
+        timer_.reset();
+    }
+
+    perf_scope(perf_scope const&) = delete;
+    perf_scope& operator=(perf_scope const&) = delete;
+
+    ~perf_scope()
+    {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    // The counts so far
+    auto read() const -> perf_counts
+    {
+        return perf_counts{
+            .elapsed = timer_.elapsed<std::chrono::nanoseconds>(),
+            .cycles = read_counter(fds_[0]),
+            .instructions = read_counter(fds_[1]),
+            .l1d_misses = read_counter(fds_[2]),
+            .llc_misses = read_counter(fds_[3]),
+            .branch_misses = read_counter(fds_[4])
+        };
+    }
+
+private:
+#ifdef __linux__
+    static auto open_counter(std::uint32_t type, std::uint64_t config) -> int
+    {
+        ::perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // So that we can scale the count if the counter was multiplexed
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd >= 0) {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        return fd;
+    }
+#endif
+
+    static auto read_counter([[maybe_unused]] int fd) -> std::optional<std::int64_t>
+    {
+#ifdef __linux__
+        struct {
+            std::uint64_t value;
+            std::uint64_t time_enabled;
+            std::uint64_t time_running;
+        } data{};
+
+        if (fd >= 0 && ::read(fd, &data, sizeof(data)) == sizeof(data) &&
+            data.time_running > 0) {
+            return static_cast<std::int64_t>(
+                double(data.value) * double(data.time_enabled) / double(data.time_running));
+        }
+#endif
+        return std::nullopt;
+    }
+
+    std::array<int, 5> fds_{-1, -1, -1, -1, -1};
+    timer timer_;
+};
+
+namespace detail {
+
+// Everything left to read from fd
+inline auto read_all(int fd) -> std::vector<char>
+{
+    std::vector<char> buffer(1 << 16);
+    std::size_t used = 0;
+    while (true) {
+        if (used == buffer.size()) {
+            buffer.resize(2 * buffer.size());
+        }
+        auto n = ::read(fd, buffer.data() + used, buffer.size() - used);
+        if (n <= 0) {
+            break;
+        }
+        used += static_cast<std::size_t>(n);
+    }
+    buffer.resize(used);
+    return buffer;
+}
+
+}
+
+// A read-only view of an input file, without copying it into a std::string.
+// Regular files are mmap()ed; anything else (stdin via "-", pipes, ...) is
+// read into a buffer instead. Setting AOC_NO_MMAP forces the buffered path,
+// and AOC_LOAD_STATS reports how long the load took, so the two can be
+// compared.
+class mapped_input {
+public:
+    explicit mapped_input(char const* path)
+    {
+        timer t;
+        load(path);
+        load_time_ = t.elapsed();
+
+        if (std::getenv("AOC_LOAD_STATS")) {
+            fmt::println(stderr, "Loaded {} bytes from {} via {} in {}",
+                         view_.size(), path, is_mapped() ? "mmap" : "read",
+                         load_time_);
+        }
+    }
+
+    mapped_input(mapped_input&& other) noexcept
+        : map_(std::exchange(other.map_, nullptr)),
+          buffer_(std::move(other.buffer_)),
+          view_(std::exchange(other.view_, {})),
+          load_time_(other.load_time_)
+    {}
+
+    mapped_input& operator=(mapped_input&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            map_ = std::exchange(other.map_, nullptr);
+            buffer_ = std::move(other.buffer_);
+            view_ = std::exchange(other.view_, {});
+            load_time_ = other.load_time_;
+        }
+        return *this;
+    }
+
+    ~mapped_input() { unmap(); }
+
+    auto view() const -> std::string_view { return view_; }
+    operator std::string_view() const { return view_; }
+
+    auto is_mapped() const -> bool { return map_ != nullptr; }
+    auto load_time() const -> std::chrono::microseconds { return load_time_; }
+
+private:
+    void load(char const* path)
+    {
+        bool const from_stdin = std::string_view(path) == "-";
+        int const fd = from_stdin ? STDIN_FILENO : ::open(path, O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error(fmt::format("Could not open {}", path));
+        }
+
+        struct ::stat st{};
+        if (!std::getenv("AOC_NO_MMAP") && ::fstat(fd, &st) == 0 &&
+            S_ISREG(st.st_mode) && st.st_size > 0) {
+            auto const size = static_cast<std::size_t>(st.st_size);
+            void* ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED) {
+                ::madvise(ptr, size, MADV_SEQUENTIAL);
+                map_ = ptr;
+                view_ = {static_cast<char const*>(ptr), size};
+            }
+        }
+
+        // Not a regular file (or mmap failed), so just read everything
+        if (!map_) {
+            buffer_ = detail::read_all(fd);
+            view_ = {buffer_.data(), buffer_.size()};
+        }
+
+        if (!from_stdin) {
+            ::close(fd);
+        }
+    }
+
+    void unmap()
+    {
+        if (map_) {
+            ::munmap(map_, view_.size());
+            map_ = nullptr;
+        }
+    }
+
+    void* map_ = nullptr;
+    std::vector<char> buffer_;
+    std::string_view view_;
+    std::chrono::microseconds load_time_{};
+};
+
+// A coroutine which produces a sequence of values with co_yield, to be used
+// with range-for (a cut-down std::generator, which not every standard library
+// we build with has yet). Each value is only valid until the next is asked
+// for, and an exception thrown by the coroutine comes out of begin() or ++.
+template <typename T>
+class generator {
+public:
+    struct promise_type {
+        T* value = nullptr;
+        std::exception_ptr error;
+
+        auto get_return_object() -> generator
+        {
+            return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+        auto final_suspend() noexcept -> std::suspend_always { return {}; }
+
+        auto yield_value(T& val) noexcept -> std::suspend_always
+        {
+            value = std::addressof(val);
+            return {};
+        }
+
+        auto yield_value(T&& val) noexcept -> std::suspend_always
+        {
+            value = std::addressof(val);
+            return {};
+        }
+
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    class iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+        auto operator*() const -> T& { return *handle_.promise().value; }
+
+        auto operator++() -> iterator&
+        {
+            advance(handle_);
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        friend auto operator==(iterator const& it, std::default_sentinel_t) -> bool
+        {
+            return it.handle_.done();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    generator(generator&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr))
+    {}
+
+    generator& operator=(generator&&) = delete;
+
+    ~generator()
+    {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    auto begin() -> iterator
+    {
+        advance(handle_);
+        return iterator(handle_);
+    }
+
+    auto end() -> std::default_sentinel_t { return {}; }
+
+private:
+    explicit generator(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    static void advance(std::coroutine_handle<promise_type> handle)
+    {
+        handle.resume();
+        if (auto error = std::exchange(handle.promise().error, nullptr)) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+#ifdef AOC_HAS_IO_URING
+// Just enough of io_uring, driven through the raw system calls, to keep a few
+// reads going in the background while the caller gets on with something else.
+// On kernels without it (before 5.6), where seccomp forbids it, or with
+// AOC_NO_URING set, ok() is false and callers fall back to plain read()s.
+class io_ring {
+public:
+    struct completion {
+        std::uint64_t user_data;
+        int result; // bytes read, or -errno
+    };
+
+    explicit io_ring(unsigned entries)
+    {
+        if (!std::getenv("AOC_NO_URING") && !setup(entries)) {
+            release();
+        }
+    }
+
+    io_ring(io_ring const&) = delete;
+    io_ring& operator=(io_ring const&) = delete;
+
+    ~io_ring()
+    {
+        // The kernel may still be writing into the caller's buffers. A read
+        // from a pipe or terminal might never finish by itself, so cancel
+        // them all first; the cancelled ones complete with -ECANCELED.
+        if (ok()) {
+            for (std::uint64_t const user_data : reading_) {
+                cancel(user_data);
+            }
+        }
+        while (ok() && in_flight_ > 0) {
+            // (reap() may have only found the completion of a cancel request)
+            if (!reap() && in_flight_ > 0) {
+                ::syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            }
+        }
+        release();
+    }
+
+    auto ok() const -> bool { return fd_ >= 0; }
+
+    // Starts reading into buf from offset in fd, or from (and advancing) the
+    // file position if offset is -1. Reads which haven't been waited for
+    // when the ring goes away are cancelled.
+    void read(int fd, std::span<char> buf, std::uint64_t offset, std::uint64_t user_data)
+    {
+        ::io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.off = offset;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(buf.data());
+        // Longer reads just come back short
+        sqe.len = static_cast<unsigned>(std::min<std::size_t>(buf.size(), 1u << 30));
+        sqe.user_data = user_data;
+        submit(sqe);
+        reading_.push_back(user_data);
+
+        while (::syscall(__NR_io_uring_enter, fd_, 1, 0, 0, nullptr, 0) < 0) {
+            if (errno != EINTR) {
+                throw std::runtime_error(fmt::format("io_uring_enter: {}", std::strerror(errno)));
+            }
+        }
+    }
+
+    // The next read to finish, in whatever order they do
+    auto wait() -> completion
+    {
+        while (true) {
+            if (auto c = reap()) {
+                return *c;
+            }
+            if (::syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                errno != EINTR) {
+                throw std::runtime_error(fmt::format("io_uring_enter: {}", std::strerror(errno)));
+            }
+        }
+    }
+
+private:
+    // The user_data of the completions of cancel requests, which wait() never
+    // sees
+    static constexpr std::uint64_t cancel_tag = std::uint64_t(-1);
+
+    void submit(::io_uring_sqe const& sqe)
+    {
+        unsigned const tail = *sq_tail_; // only we write this
+        unsigned const index = tail & sq_mask_;
+        sqes_[index] = sqe;
+        sq_array_[index] = index;
+        std::atomic_ref(*sq_tail_).store(tail + 1, std::memory_order_release);
+        ++in_flight_;
+    }
+
+    // Asks the kernel to give up on the read tagged user_data. If the request
+    // can't even be submitted we carry on waiting for the read, as before.
+    void cancel(std::uint64_t user_data)
+    {
+        ::io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.fd = -1;
+        sqe.addr = user_data;
+        sqe.user_data = cancel_tag;
+        submit(sqe);
+        long rc = 0;
+        while ((rc = ::syscall(__NR_io_uring_enter, fd_, 1, 0, 0, nullptr, 0)) < 0 && errno == EINTR) {}
+        if (rc < 1) {
+            --in_flight_;
+        }
+    }
+
+    auto setup(unsigned entries) -> bool
+    {
+        ::io_uring_params params{};
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            return false;
+        }
+        // Both rings in one mapping (5.4), and reading at the file position (5.6)
+        unsigned const needed = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_RW_CUR_POS;
+        if ((params.features & needed) != needed) {
+            return false;
+        }
+
+        ring_size_ = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                              params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe));
+        ring_ = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       fd_, IORING_OFF_SQ_RING);
+        if (ring_ == MAP_FAILED) {
+            ring_ = nullptr;
+            return false;
+        }
+        sqes_size_ = params.sq_entries * sizeof(::io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+        sqes_ = static_cast<::io_uring_sqe*>(sqes);
+
+        auto const at = [base = static_cast<char*>(ring_)](std::uint32_t offset) {
+            return reinterpret_cast<unsigned*>(base + offset);
+        };
+        sq_tail_ = at(params.sq_off.tail);
+        sq_mask_ = *at(params.sq_off.ring_mask);
+        sq_array_ = at(params.sq_off.array);
+        cq_head_ = at(params.cq_off.head);
+        cq_tail_ = at(params.cq_off.tail);
+        cq_mask_ = *at(params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<::io_uring_cqe*>(static_cast<char*>(ring_) + params.cq_off.cqes);
+        return true;
+    }
+
+    auto reap() -> std::optional<completion>
+    {
+        while (true) {
+            unsigned const head = *cq_head_; // only we write this
+            if (head == std::atomic_ref(*cq_tail_).load(std::memory_order_acquire)) {
+                return std::nullopt;
+            }
+            auto const& cqe = cqes_[head & cq_mask_];
+            completion const c{.user_data = cqe.user_data, .result = cqe.res};
+            std::atomic_ref(*cq_head_).store(head + 1, std::memory_order_release);
+            --in_flight_;
+            if (c.user_data != cancel_tag) {
+                std::erase(reading_, c.user_data);
+                return c;
+            }
+        }
+    }
+
+    void release()
+    {
+        if (sqes_) {
+            ::munmap(sqes_, sqes_size_);
+            sqes_ = nullptr;
+        }
+        if (ring_) {
+            ::munmap(ring_, ring_size_);
+            ring_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    int fd_ = -1;
+    void* ring_ = nullptr;
+    std::size_t ring_size_ = 0;
+    ::io_uring_sqe* sqes_ = nullptr;
+    std::size_t sqes_size_ = 0;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    ::io_uring_cqe* cqes_ = nullptr;
+    std::size_t in_flight_ = 0;      // reads and cancel requests
+    std::vector<std::uint64_t> reading_; // the user_data of reads in flight
+};
+#else
+// No io_uring on this platform, so callers always use plain read()s
+class io_ring {
+public:
+    struct completion {
+        std::uint64_t user_data;
+        int result;
+    };
+
+    explicit io_ring(unsigned) {}
+
+    auto ok() const -> bool { return false; }
+    void read(int, std::span<char>, std::uint64_t, std::uint64_t) {}
+    auto wait() -> completion { return {}; }
+};
+#endif
+
+}
+
+// The contents of fd, up to chunk_size bytes at a time. Using io_uring, the
+// next chunk is already being read while the caller works on this one.
+inline auto read_chunks(int fd, std::size_t chunk_size = 64 * 1024) -> generator<std::string_view>
+{
+    std::array buffers{std::vector<char>(chunk_size), std::vector<char>(chunk_size)};
+
+    detail::io_ring ring(2);
+    if (ring.ok()) {
+        auto const at_position = static_cast<std::uint64_t>(-1);
+        std::size_t cur = 0;
+        ring.read(fd, buffers[cur], at_position, cur);
+        while (true) {
+            auto const n = ring.wait().result;
+            if (n == -EINTR || n == -EAGAIN) {
+                ring.read(fd, buffers[cur], at_position, cur);
+                continue;
+            }
+            if (n < 0) {
+                throw std::runtime_error(fmt::format("Error reading input: {}", std::strerror(-n)));
+            }
+            if (n == 0) {
+                co_return;
+            }
+            ring.read(fd, buffers[cur ^ 1], at_position, cur ^ 1);
+            co_yield std::string_view(buffers[cur].data(), static_cast<std::size_t>(n));
+            cur ^= 1;
+        }
+    }
+
+    while (true) {
+        auto const n = ::read(fd, buffers[0].data(), chunk_size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw std::runtime_error(fmt::format("Error reading input: {}", std::strerror(errno)));
+        }
+        if (n == 0) {
+            co_return;
+        }
+        co_yield std::string_view(buffers[0].data(), static_cast<std::size_t>(n));
+    }
+}
+
+// A whole input file, as produced by read_files()
+struct file_contents {
+    std::vector<char> data;
+    std::exception_ptr error; // why the file couldn't be read, if it couldn't
+
+    auto view() const -> std::string_view { return {data.data(), data.size()}; }
+};
+
+// The contents of each file in paths (which must outlive the generator), in
+// order. Using io_uring, up to depth regular files are read at once while the
+// caller works on the ones before them; anything else (stdin via "-", pipes,
+// ...) is read as its turn comes. A file which can't be read is passed on
+// with its error, rather than stopping the rest.
+inline auto read_files(std::vector<std::string> const& paths, std::size_t depth = 8)
+    -> generator<file_contents>
+{
+    depth = std::max<std::size_t>(depth, 1);
+
+    struct pending {
+        file_contents file;
+        int fd = -1;
+        std::size_t done = 0; // bytes read so far
+        bool ready = true;
+
+        pending() = default;
+        pending(pending const&) = delete;
+        pending& operator=(pending const&) = delete;
+        ~pending() { close(); }
+
+        void close()
+        {
+            if (fd > STDIN_FILENO) {
+                ::close(fd);
+            }
+            fd = -1;
+            ready = true;
+        }
+    };
+    std::vector<pending> slots(depth);
+    detail::io_ring ring(static_cast<unsigned>(depth));
+
+    auto const start = [&](std::size_t i) {
+        auto& p = slots[i % depth];
+        p.file = {};
+        p.done = 0;
+        try {
+            p.fd = paths[i] == "-" ? STDIN_FILENO : ::open(paths[i].c_str(), O_RDONLY);
+            if (p.fd < 0) {
+                throw std::runtime_error(fmt::format("Could not open {}", paths[i]));
+            }
+            struct ::stat st{};
+            if (ring.ok() && ::fstat(p.fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                p.file.data.resize(static_cast<std::size_t>(st.st_size));
+                p.ready = false;
+                ring.read(p.fd, p.file.data, 0, i % depth);
+                return;
+            }
+            p.file.data = detail::read_all(p.fd);
+        } catch (...) {
+            p.file.error = std::current_exception();
+        }
+        p.close();
+    };
+
+    auto const complete = [&](detail::io_ring::completion c) {
+        auto& p = slots[c.user_data];
+        if (c.result == -EINTR || c.result == -EAGAIN) {
+            ring.read(p.fd, std::span(p.file.data).subspan(p.done), p.done, c.user_data);
+            return;
+        }
+        if (c.result < 0) {
+            p.file.data.clear();
+            p.file.error = std::make_exception_ptr(std::runtime_error(
+                fmt::format("Error reading input: {}", std::strerror(-c.result))));
+        } else if (c.result == 0) {
+            p.file.data.resize(p.done); // it got shorter
+        } else {
+            p.done += static_cast<std::size_t>(c.result);
+            if (p.done < p.file.data.size()) {
+                ring.read(p.fd, std::span(p.file.data).subspan(p.done), p.done, c.user_data);
+                return;
+            }
+        }
+        p.close();
+    };
+
+    for (std::size_t i = 0; i < std::min(depth, paths.size()); ++i) {
+        start(i);
+    }
+
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        auto& p = slots[i % depth];
+        while (!p.ready) {
+            complete(ring.wait());
+        }
+        auto file = std::move(p.file);
+        if (i + depth < paths.size()) {
+            start(i + depth);
+        }
+        co_yield file;
+    }
+}
+
+// Calls fn(record) for each record in text separated by delimiter. A final
+// empty record (i.e. a trailing delimiter) is skipped.
+constexpr void split_records(std::string_view text, char delimiter, auto&& fn)
+{
+    std::size_t end = 0;
+    while ((end = text.find(delimiter)) != std::string_view::npos) {
+        fn(text.substr(0, end));
+        text.remove_prefix(end + 1);
+    }
+    if (!text.empty()) {
+        fn(text);
+    }
+}
+
+// As split_records(), but reading from a file descriptor chunk_size bytes at a
+// time (see read_chunks()). Only the chunks being read and worked on are held
+// in memory, plus the start of a record which runs over into the next one.
+template <typename Fn>
+void stream_records(int fd, char delimiter, Fn&& fn, std::size_t chunk_size = 64 * 1024)
+{
+    std::string carry; // the partial record carried over from the last chunk
+
+    for (std::string_view chunk : read_chunks(fd, chunk_size)) {
+        if (!carry.empty()) {
+            auto const end = chunk.find(delimiter);
+            if (end == std::string_view::npos) {
+                carry.append(chunk);
+                continue;
+            }
+            carry.append(chunk.substr(0, end));
+            fn(std::string_view(carry));
+            carry.clear();
+            chunk.remove_prefix(end + 1);
+        }
+
+        auto const last = chunk.rfind(delimiter);
+        if (last == std::string_view::npos) {
+            carry.assign(chunk);
+            continue;
+        }
+        split_records(chunk.substr(0, last + 1), delimiter, fn);
+        carry.assign(chunk.substr(last + 1));
+    }
+
+    if (!carry.empty()) {
+        fn(std::string_view(carry));
+    }
+}
+
+// One part of a day's solution as a fold over the records of its input: the
+// answer is finish(state) after step(state, record) for each record, where
+// step updates state in place (so that a large state is never copied).
+template <typename State, typename Step, typename Finish = std::identity>
+struct record_fold {
+    State init;
+    Step step;
+    Finish finish = {};
+};
+
+// Both parts of a day's solution as record_folds over records separated by
+// delimiter, so that they can be worked out in a single pass over an input of
+// any size in constant memory. run() uses this for input read from stdin.
+template <typename Part1, typename Part2>
+struct streaming_solution {
+    char delimiter;
+    Part1 part1;
+    Part2 part2;
+};
+
+// Runs a record_fold over the whole of text, e.g. to test it
+constexpr auto fold_records = [](auto const& fold, char delimiter, std::string_view text)
+{
+    auto state = fold.init;
+    split_records(text, delimiter, [&](std::string_view record) {
+        fold.step(state, record);
+    });
+    return fold.finish(std::move(state));
+};
+
+// Heap allocation statistics for a region of code. These are only available
+// when configured with -DAOC_TRACK_ALLOCS=ON, which links in the replacement
+// operator new and delete in aoc_alloc.cpp.
+struct alloc_stats {
+    std::int64_t count = 0;
+    std::int64_t bytes = 0;
+    std::int64_t peak_bytes = 0; // highest live bytes, relative to the start
+};
+
+namespace detail {
+
+#ifdef AOC_TRACK_ALLOCS
+inline constexpr bool tracking_allocs = true;
+#else
+inline constexpr bool tracking_allocs = false;
+#endif
+
+// The counters themselves are in aoc_alloc.hpp
+
+}
+
+// Measures the allocations made between its construction and finish(). These
+// can be nested, but allocations by other threads are counted too.
+class alloc_scope {
+public:
+    alloc_scope()
+        : count_(detail::allocs.count.load()),
+          bytes_(detail::allocs.bytes.load()),
+          live_(detail::allocs.live.load()),
+          saved_peak_(detail::allocs.peak.exchange(live_))
+    {}
+
+    auto finish() const -> alloc_stats
+    {
+        alloc_stats stats{
+            .count = detail::allocs.count.load() - count_,
+            .bytes = detail::allocs.bytes.load() - bytes_,
+            .peak_bytes = detail::allocs.peak.load() - live_
+        };
+        detail::raise_peak(saved_peak_);
+        return stats;
+    }
+
+private:
+    std::int64_t count_;
+    std::int64_t bytes_;
+    std::int64_t live_;
+    std::int64_t saved_peak_;
+};
+
+// Timings of named, possibly nested, phases of a run, e.g.
+//
+//     aoc::phase p("parse");
+//
+// Enabled by passing --timings to a day's executable, or by setting
+// AOC_TIMINGS; the results are then written to stderr as JSON, along with the
+// heap allocations made in each phase if those are being tracked. Passing
+// --perf (or setting AOC_PERF) adds hardware counters from aoc::perf_scope.
+// When disabled, constructing a phase does nothing beyond checking a flag.
+namespace detail {
+
+inline bool perf_enabled = std::getenv("AOC_PERF") != nullptr;
+inline bool timings_enabled = perf_enabled || std::getenv("AOC_TIMINGS") != nullptr;
+
+struct phase_record {
+    std::string name;
+    int parent;
+    std::chrono::nanoseconds elapsed{};
+    std::optional<alloc_stats> allocs{};
+    std::optional<perf_counts> counters{};
+};
+
+struct timings_state {
+    std::mutex mutex;
+    std::vector<phase_record> records;
+};
+
+inline auto timings() -> timings_state&
+{
+    static timings_state state;
+    return state;
+}
+
+inline thread_local int current_phase = -1;
+
+}
+
+class phase {
+public:
+    explicit phase(std::string_view name)
+    {
+        if (!detail::timings_enabled) {
+            return;
+        }
+
+        auto& state = detail::timings();
+        {
+            std::scoped_lock lock(state.mutex);
+            idx_ = static_cast<int>(state.records.size());
+            state.records.push_back({.name = std::string(name),
+                                     .parent = detail::current_phase});
+        }
+        detail::current_phase = idx_;
+        timer_.emplace();
+        if (detail::perf_enabled) {
+            perf_.emplace();
+        }
+        if constexpr (detail::tracking_allocs) {
+            allocs_.emplace();
+        }
+    }
+
+    phase(phase const&) = delete;
+    phase& operator=(phase const&) = delete;
+
+    ~phase()
+    {
+        if (!timer_) {
+            return;
+        }
+
+        auto const elapsed = timer_->elapsed<std::chrono::nanoseconds>();
+        auto const counters = perf_ ? std::optional(perf_->read()) : std::nullopt;
+        auto const allocs = allocs_ ? std::optional(allocs_->finish()) : std::nullopt;
+        auto& state = detail::timings();
+        std::scoped_lock lock(state.mutex);
+        auto& record = state.records.at(idx_);
+        record.elapsed = elapsed;
+        record.allocs = allocs;
+        record.counters = counters;
+        detail::current_phase = record.parent;
+    }
+
+private:
+    int idx_ = -1;
+    std::optional<timer> timer_;
+    std::optional<alloc_scope> allocs_;
+    std::optional<perf_scope> perf_;
+};
+
+// Writes all the phases recorded so far as
+// {"phases": [{"name": "parse", "us": 12.3, "phases": [...]}, ...]}
+// with "allocs", "alloc_bytes" and "peak_bytes" too when tracking allocations,
+// and "cycles", "instructions", etc. for whichever counters are available
+inline void write_timings(std::FILE* out)
+{
+    auto& state = detail::timings();
+    std::scoped_lock lock(state.mutex);
+
+    auto write_children = [&](auto const& self, int parent) -> void {
+        fmt::print(out, "[");
+        bool first = true;
+        for (std::size_t idx = 0; idx < state.records.size(); ++idx) {
+            auto const& rec = state.records[idx];
+            if (rec.parent != parent) {
+                continue;
+            }
+            fmt::print(out, "{}{{\"name\": \"{}\", \"us\": {:.3f}, ",
+                       first ? "" : ", ", rec.name,
+                       std::chrono::duration<double, std::micro>(rec.elapsed).count());
+            if (rec.allocs) {
+                fmt::print(out, "\"allocs\": {}, \"alloc_bytes\": {}, \"peak_bytes\": {}, ",
+                           rec.allocs->count, rec.allocs->bytes, rec.allocs->peak_bytes);
+            }
+            if (rec.counters) {
+                auto print_counter = [&](std::string_view name, std::optional<std::int64_t> value) {
+                    if (value) {
+                        fmt::print(out, "\"{}\": {}, ", name, *value);
+                    }
+                };
+                print_counter("cycles", rec.counters->cycles);
+                print_counter("instructions", rec.counters->instructions);
+                print_counter("l1d_misses", rec.counters->l1d_misses);
+                print_counter("llc_misses", rec.counters->llc_misses);
+                print_counter("branch_misses", rec.counters->branch_misses);
+            }
+            fmt::print(out, "\"phases\": ");
+            self(self, static_cast<int>(idx));
+            fmt::print(out, "}}");
+            first = false;
+        }
+        fmt::print(out, "]");
+    };
+
+    fmt::print(out, "{{\"phases\": ");
+    write_children(write_children, -1);
+    fmt::print(out, "}}\n");
+}
+
+// A fixed set of worker threads, each with its own queue of tasks. Workers
+// take tasks from the back of their own queue, and when that is empty steal
+// from the front of the others', so that wildly uneven tasks still keep every
+// thread busy. Threads waiting for a parallel_for() to finish help with that
+// call's own tasks, so calls can be nested; they never start unrelated ones,
+// which could keep the caller waiting long after its own work was done (and
+// would have the other task's phases timed as part of it).
+class thread_pool {
+public:
+    // n_threads includes the calling thread, so 1 means no workers at all
+    explicit thread_pool(unsigned n_threads)
+    {
+        auto const n_workers = n_threads > 1 ? n_threads - 1 : 0;
+        for (unsigned i = 0; i < n_workers; ++i) {
+            queues_.push_back(std::make_unique<task_queue>());
+        }
+        for (unsigned i = 0; i < n_workers; ++i) {
+            workers_.emplace_back([this, i](std::stop_token stop) { work(i, stop); });
+        }
+    }
+
+    thread_pool(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    auto size() const -> unsigned { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    // Calls fn(i) for each i in [first, last), as separate tasks
+    template <typename Fn>
+    void parallel_for(std::int64_t first, std::int64_t last, Fn&& fn)
+    {
+        if (workers_.empty() || last - first <= 1) {
+            for (auto i = first; i < last; ++i) {
+                fn(i);
+            }
+            return;
+        }
+
+        std::atomic<std::int64_t> remaining{last - first};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        void const* const group = &remaining; // identifies this call's tasks
+
+        for (auto i = first; i < last; ++i) {
+            push(group, [&, i] {
+                try {
+                    fn(i);
+                } catch (...) {
+                    std::scoped_lock lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!try_run_one(group)) {
+                std::this_thread::yield();
+            }
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Combines map(i) for each i in [first, last) using reduce, in order
+    template <typename T, typename Map, typename Reduce = std::plus<>>
+    auto parallel_reduce(std::int64_t first, std::int64_t last, T init,
+                         Map&& map, Reduce reduce = {}) -> T
+    {
+        std::vector<T> results(std::max<std::int64_t>(last - first, 0), init);
+        parallel_for(first, last, [&](std::int64_t i) {
+            results[i - first] = map(i);
+        });
+        for (T& r : results) {
+            init = reduce(std::move(init), std::move(r));
+        }
+        return init;
+    }
+
+private:
+    struct task {
+        void const* group; // the parallel_for() call it belongs to
+        std::function<void()> fn;
+    };
+
+    struct task_queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    void push(void const* group, std::function<void()> fn)
+    {
+        auto const idx = current_pool_ == this
+                             ? worker_idx_
+                             : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::scoped_lock lock(queues_[idx]->mutex);
+            queues_[idx]->tasks.push_back(task{group, std::move(fn)});
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+        // Taking the lock ensures a worker can't miss the notification
+        // between checking queued_ and going to sleep
+        { std::scoped_lock lock(sleep_mutex_); }
+        sleep_cv_.notify_one();
+    }
+
+    // Takes the task nearest the back (or front) of queue, or with a group,
+    // the nearest which belongs to it
+    static auto take(task_queue& queue, void const* group, bool from_back) -> std::optional<task>
+    {
+        std::scoped_lock lock(queue.mutex);
+        auto const matches = [group](task const& t) { return !group || t.group == group; };
+        auto& tasks = queue.tasks;
+        auto iter = tasks.end();
+        if (from_back) {
+            auto const riter = std::find_if(tasks.rbegin(), tasks.rend(), matches);
+            if (riter != tasks.rend()) {
+                iter = std::prev(riter.base());
+            }
+        } else {
+            iter = std::find_if(tasks.begin(), tasks.end(), matches);
+        }
+        if (iter == tasks.end()) {
+            return std::nullopt;
+        }
+        std::optional<task> t(std::move(*iter));
+        tasks.erase(iter);
+        return t;
+    }
+
+    // Runs a queued task, if there is one, from group if not null
+    auto try_run_one(void const* group = nullptr) -> bool
+    {
+        std::optional<task> t;
+        auto const n = queues_.size();
+        bool const is_worker = current_pool_ == this;
+
+        if (is_worker) {
+            t = take(*queues_[worker_idx_], group, true);
+        }
+
+        for (std::size_t k = 0; !t && k < n; ++k) {
+            t = take(*queues_[(worker_idx_ + k + is_worker) % n], group, false);
+        }
+
+        if (!t) {
+            return false;
+        }
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        t->fn();
+        return true;
+    }
+
+    void work(unsigned idx, std::stop_token stop)
+    {
+        current_pool_ = this;
+        worker_idx_ = idx;
+
+        while (!stop.stop_requested()) {
+            if (try_run_one()) {
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            sleep_cv_.wait(lock, stop, [this] {
+                return queued_.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+
+    static inline thread_local thread_pool* current_pool_ = nullptr;
+    static inline thread_local std::size_t worker_idx_ = 0;
+
+    std::vector<std::unique_ptr<task_queue>> queues_;
+    std::atomic<std::size_t> next_queue_{0};
+    std::atomic<std::int64_t> queued_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable_any sleep_cv_;
+    // Last, so that the workers are stopped before anything else goes away
+    std::vector<std::jthread> workers_;
+};
+
+namespace detail {
+
+inline auto pool() -> std::unique_ptr<thread_pool>&
+{
+    static std::unique_ptr<thread_pool> p = [] {
+        auto const* env = std::getenv("AOC_THREADS");
+        auto n = env ? try_parse<unsigned>(std::string_view(env)) : std::nullopt;
+        return std::make_unique<thread_pool>(
+            n.value_or(std::max(1u, std::thread::hardware_concurrency())));
+    }();
+    return p;
+}
+
+}
+
+// The pool used by aoc::parallel_for() and aoc::parallel_reduce(). By default
+// it uses every core, or AOC_THREADS if set; days' executables also accept
+// --threads N.
+inline auto default_pool() -> thread_pool& { return *detail::pool(); }
+
+// Must not be called while the default pool is in use
+inline void set_thread_count(unsigned n_threads)
+{
+    detail::pool() = std::make_unique<thread_pool>(std::max(1u, n_threads));
+}
+
+template <typename Fn>
+void parallel_for(std::int64_t first, std::int64_t last, Fn&& fn)
+{
+    default_pool().parallel_for(first, last, std::forward<Fn>(fn));
+}
+
+template <typename T, typename Map, typename Reduce = std::plus<>>
+auto parallel_reduce(std::int64_t first, std::int64_t last, T init,
+                     Map&& map, Reduce reduce = {}) -> T
+{
+    return default_pool().parallel_reduce(first, last, std::move(init),
+                                          std::forward<Map>(map), std::move(reduce));
+}
+
+// Parses each non-empty line of input with fn, returning the results in order.
+// Large inputs are split at newlines into roughly equal chunks, a few per
+// thread, which are parsed concurrently and then joined, giving exactly the
+// same vector as parsing line by line.
+constexpr auto parse_lines =
+[]<typename Fn>(std::string_view input, Fn fn)
+    -> std::vector<std::remove_cvref_t<std::invoke_result_t<Fn&, std::string_view>>>
+{
+    auto parse_chunk = [&fn](std::string_view chunk) {
+        return line_index(chunk).lines()
+                .filter([](std::string_view line) { return !line.empty(); })
+                .map(fn)
+                .template to<std::vector>();
+    };
+
+    // Below this, it's not worth waking up the other threads
+    constexpr std::size_t min_chunk_size = 64 * 1024;
+
+    if consteval {
+        return parse_chunk(input);
+    } else {
+        auto const max_chunks = 4 * static_cast<std::size_t>(default_pool().size());
+        auto const n_chunks = std::clamp<std::size_t>(input.size() / min_chunk_size, 1, max_chunks);
+        if (n_chunks == 1) {
+            return parse_chunk(input);
+        }
+
+        std::vector<std::string_view> chunks;
+        std::size_t start = 0;
+        for (std::size_t i = 1; i <= n_chunks && start < input.size(); ++i) {
+            std::size_t end = input.size();
+            if (i < n_chunks) {
+                end = input.find('\n', std::max(start, i * input.size() / n_chunks));
+                end = end == input.npos ? input.size() : end + 1;
+            }
+            chunks.push_back(input.substr(start, end - start));
+            start = end;
+        }
+
+        std::vector<decltype(parse_chunk(input))> results(chunks.size());
+        parallel_for(0, flux::size(chunks), [&](std::int64_t i) {
+            results[i] = parse_chunk(chunks[i]);
+        });
+
+        auto out = std::move(results.front());
+        std::size_t total = 0;
+        for (auto const& r : results) {
+            total += r.size();
+        }
+        out.reserve(total);
+        for (std::size_t i = 1; i < results.size(); ++i) {
+            std::ranges::move(results[i], std::back_inserter(out));
+        }
+        return out;
+    }
+};
+
+// A day's solution: a parser for the input, and the two parts which are run
+// on whatever the parser returns
+template <typename Parse, typename Part1, typename Part2>
+struct solution {
+    Parse parse;
+    Part1 part1;
+    Part2 part2;
+};
+
+// For days which work directly on the input text
+constexpr auto raw_input = [](std::string_view input) { return input; };
+
+// Type-erased interface to a solution, so that tools can run several days in
+// one process. Answers are returned already formatted.
+struct day {
+    using state_t = std::shared_ptr<void const>;
+
+    std::string name;
+    std::function<state_t(std::string_view)> parse;
+    std::function<std::string(state_t const&)> part1;
+    std::function<std::string(state_t const&)> part2;
+    // Rough relative running time, so that slow days can be started first
+    int cost = 1;
+};
+
+inline auto registered_days() -> std::vector<day>&
+{
+    static std::vector<day> days;
+    return days;
+}
+
+template <typename Parse, typename Part1, typename Part2>
+auto make_day(std::string_view name,
+              solution<Parse, Part1, Part2> const& sol,
+              int cost = 1) -> day
+{
+    using state_type = std::remove_cvref_t<
+        std::invoke_result_t<Parse const&, std::string_view>>;
+
+    auto get = [](day::state_t const& state) -> state_type const& {
+        return *static_cast<state_type const*>(state.get());
+    };
+
+    return day{
+        .name = std::string(name),
+        .parse = [sol](std::string_view input) -> day::state_t {
+            return std::make_shared<state_type const>(sol.parse(input));
+        },
+        .part1 = [sol, get](day::state_t const& state) -> std::string {
+            return fmt::format("{}", sol.part1(get(state)));
+        },
+        .part2 = [sol, get](day::state_t const& state) -> std::string {
+            return fmt::format("{}", sol.part2(get(state)));
+        },
+        .cost = cost
+    };
+}
+
+template <typename Parse, typename Part1, typename Part2>
+auto register_day(std::string_view name,
+                  solution<Parse, Part1, Part2> const& sol,
+                  int cost = 1) -> bool
+{
+    registered_days().push_back(make_day(name, sol, cost));
+    return true;
+}
+
+using main_fn = int (*)(int, char**);
+
+inline auto registered_mains() -> std::vector<main_fn>&
+{
+    static std::vector<main_fn> mains;
+    return mains;
+}
+
+// Each day registers the function its executable runs, which does the day's
+// runtime tests and calls run(). The main() in aoc_main.cpp calls the one
+// which is linked in, so that each day is compiled just once, into an object
+// library shared with aoc_all and aoc_bench, rather than again with a main().
+inline auto register_main(main_fn fn) -> bool
+{
+    registered_mains().push_back(fn);
+    return true;
+}
+
+namespace detail {
+
+// The parsed state of the inputs the server has seen recently, along with any
+// answers already worked out from them, and the threads which serve clients.
+// Only the max_inputs most recently used inputs are kept, and at most
+// max_clients clients are served at once.
+class server {
+public:
+    server(std::vector<day> days, unsigned max_clients, std::size_t max_inputs)
+        : days_(std::move(days)),
+          max_inputs_(std::max<std::size_t>(max_inputs, 1)),
+          idle_(std::max(max_clients, 1u))
+    {
+        for (unsigned i = 0; i < std::max(max_clients, 1u); ++i) {
+            threads_.emplace_back([this](std::stop_token stop) { work(stop); });
+        }
+    }
+
+    server(server const&) = delete;
+    server& operator=(server const&) = delete;
+
+    // Disconnects any clients still being served, so that the threads can
+    // be stopped
+    ~server()
+    {
+        std::scoped_lock lock(clients_mutex_);
+        for (int fd : pending_) {
+            ::close(fd);
+        }
+        pending_.clear();
+        for (int fd : active_) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+
+    // Waits until a thread is free to serve another client
+    void wait_for_thread() { idle_.acquire(); }
+
+    // Hands a newly accepted client to the thread wait_for_thread() found
+    void add_client(int fd)
+    {
+        {
+            std::scoped_lock lock(clients_mutex_);
+            pending_.push_back(fd);
+        }
+        clients_cv_.notify_one();
+    }
+
+private:
+    void work(std::stop_token stop)
+    {
+        while (true) {
+            int fd = -1;
+            {
+                std::unique_lock lock(clients_mutex_);
+                if (!clients_cv_.wait(lock, stop, [this] { return !pending_.empty(); })) {
+                    return;
+                }
+                fd = pending_.front();
+                pending_.pop_front();
+                active_.push_back(fd);
+            }
+            serve_client(fd);
+            {
+                std::scoped_lock lock(clients_mutex_);
+                std::erase(active_, fd);
+            }
+            ::close(fd);
+            idle_.release();
+        }
+    }
+
+    void serve_client(int fd)
+    {
+        std::string buffer;
+        std::array<char, 4096> chunk;
+        while (true) {
+            auto const n = ::read(fd, chunk.data(), chunk.size());
+            if (n <= 0) {
+                break;
+            }
+            buffer.append(chunk.data(), static_cast<std::size_t>(n));
+
+            std::size_t end = 0;
+            while ((end = buffer.find('\n')) != std::string::npos) {
+                auto const reply = respond(std::string_view(buffer).substr(0, end)) + '\n';
+                buffer.erase(0, end + 1);
+                if (!send_all(fd, reply)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    struct entry {
+        std::mutex mutex;
+        ::timespec mtime{};
+        ::off_t size = -1; // -1 if we haven't successfully parsed this input
+        std::string input;
+        day::state_t state;
+        std::array<std::optional<std::string>, 2> answers;
+    };
+
+    auto respond(std::string_view request) -> std::string
+    {
+        try {
+            return "ok " + answer(request);
+        } catch (std::exception const& e) {
+            return fmt::format("error {}", e.what());
+        }
+    }
+
+    auto answer(std::string_view request) -> std::string
+    {
+        // <day> part1|part2 <input-path>, where the path may contain spaces
+        auto const sp1 = request.find(' ');
+        auto const sp2 = request.find(' ', sp1 == request.npos ? sp1 : sp1 + 1);
+        if (sp2 == request.npos) {
+            throw std::runtime_error("Expected <day> part1|part2 <input-path>");
+        }
+        auto const name = request.substr(0, sp1);
+        auto const part_name = request.substr(sp1 + 1, sp2 - sp1 - 1);
+        auto const path = std::string(request.substr(sp2 + 1));
+
+        auto const day_iter = std::ranges::find(days_, name, &day::name);
+        if (day_iter == days_.end()) {
+            throw std::runtime_error(fmt::format("Unknown day {}", name));
+        }
+        if (part_name != "part1" && part_name != "part2") {
+            throw std::runtime_error(fmt::format("Unknown part {}", part_name));
+        }
+        int const part = part_name == "part1" ? 0 : 1;
+
+        // The client's working directory may not be ours
+        if (!path.starts_with('/')) {
+            throw std::runtime_error(fmt::format("Input path must be absolute: {}", path));
+        }
+
+        struct ::stat st{};
+        if (::stat(path.c_str(), &st) != 0) {
+            throw std::runtime_error(fmt::format("Could not open {}", path));
+        }
+
+        auto const e = [&] {
+            std::lock_guard lock(mutex_);
+            auto& [ptr, last_used] = entries_[std::pair(std::string(name), path)];
+            if (!ptr) {
+                ptr = std::make_shared<entry>();
+            }
+            last_used = ++uses_;
+            auto result = ptr;
+            // Forget the least recently used input (though anyone still using
+            // it keeps it alive until they're done)
+            if (entries_.size() > max_inputs_) {
+                entries_.erase(std::ranges::min_element(entries_, {}, [](auto const& kv) {
+                    return kv.second.second;
+                }));
+            }
+            return result;
+        }();
+
+        // Queries on the same input wait for each other, so that it's only
+        // parsed once
+        std::lock_guard lock(e->mutex);
+        if (st.st_size != e->size || st.st_mtim.tv_sec != e->mtime.tv_sec ||
+            st.st_mtim.tv_nsec != e->mtime.tv_nsec) {
+            e->size = -1;
+            e->answers = {};
+            // Some days' parsed state refers into the input, so drop it first
+            e->state.reset();
+            // Take a copy rather than keeping the file mapped, in case it's
+            // truncated while we're using it
+            e->input = std::string(mapped_input(path.c_str()).view());
+            e->state = day_iter->parse(e->input);
+            e->mtime = st.st_mtim;
+            e->size = st.st_size;
+        }
+
+        auto& ans = e->answers[part];
+        if (!ans) {
+            ans = part == 0 ? day_iter->part1(e->state) : day_iter->part2(e->state);
+        }
+        return *ans;
+    }
+
+    static auto send_all(int fd, std::string_view data) -> bool
+    {
+        while (!data.empty()) {
+            auto const n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            data.remove_prefix(static_cast<std::size_t>(n));
+        }
+        return true;
+    }
+
+    std::vector<day> days_;
+    std::size_t max_inputs_;
+
+    std::mutex mutex_;
+    // Keyed on (day, path), along with when each was last used
+    std::map<std::pair<std::string, std::string>,
+             std::pair<std::shared_ptr<entry>, std::uint64_t>> entries_;
+    std::uint64_t uses_ = 0;
+
+    std::counting_semaphore<> idle_;
+    std::mutex clients_mutex_;
+    std::condition_variable_any clients_cv_;
+    std::deque<int> pending_;
+    std::vector<int> active_;
+    // Last, so that the threads are stopped before anything else goes away
+    std::vector<std::jthread> threads_;
+};
+
+}
+
+// Answers requests for the given days over a Unix domain socket, keeping the
+// parsed state of each input in memory (along with the answers) until the
+// file's modification time or size changes. Clients send lines of the form
+//
+//     dec08 part2 /path/to/input.txt
+//
+// and get back a line "ok <answer>" or "error <message>" for each. Paths must
+// be absolute, since the server's working directory isn't the client's. Up to
+// max_clients connections are served at once, each on its own thread, and
+// others wait to be accepted; only the max_inputs most recently used inputs
+// are kept. Only returns if something goes wrong with the socket.
+inline auto serve(std::vector<day> days, char const* socket_path,
+                  unsigned max_clients = 16, std::size_t max_inputs = 64) -> int
+{
+    ::sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (std::strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fmt::println(stderr, "Socket path too long: {}", socket_path);
+        return -1;
+    }
+    std::strcpy(addr.sun_path, socket_path);
+
+    // Clear away a socket left behind by an earlier server, but nothing else
+    if (struct ::stat st{}; ::stat(socket_path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        ::unlink(socket_path);
+    }
+
+    int const listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0 ||
+        ::bind(listen_fd, reinterpret_cast<::sockaddr const*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd, SOMAXCONN) != 0) {
+        fmt::println(stderr, "Could not listen on {}: {}", socket_path, std::strerror(errno));
+        if (listen_fd >= 0) {
+            ::close(listen_fd);
+        }
+        return -1;
+    }
+    fmt::println(stderr, "Listening on {}", socket_path);
+
+    detail::server srv(std::move(days), max_clients, max_inputs);
+    while (true) {
+        srv.wait_for_thread();
+        int client = -1;
+        do {
+            client = ::accept(listen_fd, nullptr, nullptr);
+        } while (client < 0 && (errno == EINTR || errno == ECONNABORTED));
+        if (client < 0) {
+            fmt::println(stderr, "accept() failed: {}", std::strerror(errno));
+            ::close(listen_fd);
+            return -1;
+        }
+        srv.add_client(client);
+    }
+}
+
+namespace detail {
+
+enum class cache_mode { off, on, verify };
+
+inline cache_mode answer_cache_mode = [] {
+    char const* env = std::getenv("AOC_CACHE");
+    if (!env) {
+        return cache_mode::off;
+    }
+    return std::string_view(env) == "verify" ? cache_mode::verify : cache_mode::on;
+}();
+
+// The path to the running executable, for when /proc/self/exe isn't there to
+// read. run() sets this from argv[0].
+inline std::string exe_path;
+
+// A hash of the running executable's contents, or empty if it can't be read
+inline auto exe_hash() -> std::string
+{
+    for (std::string const& path : {std::string("/proc/self/exe"), exe_path}) {
+        if (path.empty()) {
+            continue;
+        }
+        try {
+            auto const exe = mapped_input(path.c_str());
+            return fmt::format("{}-{:016x}", exe.view().size(),
+                               ankerl::unordered_dense::hash<std::string_view>{}(exe.view()));
+        } catch (std::runtime_error const&) {
+        }
+    }
+    return {};
+}
+
+// Identifies the running executable, and changes whenever the code does: the
+// GNU build ID as a hex string if the linker added one, or else a hash of the
+// executable itself (not the time this header was compiled, which is frozen
+// in the precompiled header). Empty if neither can be found.
+inline auto build_id() -> std::string const&
+{
+    static std::string const id = [] {
+        std::string id;
+#ifdef __linux__
+        dl_iterate_phdr([](dl_phdr_info* info, std::size_t, void* data) -> int {
+            for (int i = 0; i < info->dlpi_phnum; ++i) {
+                auto const& ph = info->dlpi_phdr[i];
+                if (ph.p_type != PT_NOTE) {
+                    continue;
+                }
+                auto const* p = reinterpret_cast<char const*>(info->dlpi_addr + ph.p_vaddr);
+                auto const* const end = p + ph.p_memsz;
+                while (p + sizeof(ElfW(Nhdr)) <= end) {
+                    auto const* note = reinterpret_cast<ElfW(Nhdr) const*>(p);
+                    auto const* name = p + sizeof(ElfW(Nhdr));
+                    auto const* desc = name + ((note->n_namesz + 3) & ~3u);
+                    if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 &&
+                        std::memcmp(name, "GNU", 4) == 0) {
+                        auto const bytes = std::span(reinterpret_cast<unsigned char const*>(desc),
+                                                     note->n_descsz);
+                        *static_cast<std::string*>(data) = fmt::format("{:02x}", fmt::join(bytes, ""));
+                        break;
+                    }
+                    p = desc + ((note->n_descsz + 3) & ~3u);
+                }
+            }
+            return 1; // the executable comes first, so stop there
+        }, &id);
+#endif
+        if (id.empty()) {
+            id = exe_hash();
+        }
+        return id;
+    }();
+    return id;
+}
+
+}
+
+// Answers saved on disk from earlier runs. Each entry starts with a line
+// giving the day, the size and hash of its input and the executable's build
+// ID, which must all match for the entry to be used, so rebuilding or changing
+// the input never finds stale answers; the file is named after a hash of that
+// line. They live in AOC_CACHE_DIR if set, or else $XDG_CACHE_HOME/aoc2023 (by
+// default ~/.cache/aoc2023).
+class answer_cache {
+public:
+    struct answers {
+        std::string part1;
+        std::string part2;
+
+        friend auto operator==(answers const&, answers const&) -> bool = default;
+    };
+
+    answer_cache(std::string_view day, std::string_view input)
+        : header_(fmt::format("{} {} {:016x} {}", day, input.size(),
+                              ankerl::unordered_dense::hash<std::string_view>{}(input),
+                              detail::build_id()))
+    {
+        auto const key = ankerl::unordered_dense::hash<std::string_view>{}(header_);
+        path_ = directory() / fmt::format("{}-{:016x}", day, key);
+    }
+
+    auto load() const -> std::optional<answers>
+    {
+        std::ifstream in(path_);
+        std::string header;
+        answers a;
+        if (!std::getline(in, header) || header != header_ ||
+            !std::getline(in, a.part1) || !std::getline(in, a.part2)) {
+            return std::nullopt;
+        }
+        return a;
+    }
+
+    // Failing to save is not an error, just a missed opportunity
+    void store(answers const& a) const
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(path_.parent_path(), ec);
+
+        // Write to a temporary file first, so that other processes never see
+        // a partial entry
+        auto tmp = path_;
+        tmp += fmt::format(".{}", ::getpid());
+        {
+            std::ofstream out(tmp);
+            out << header_ << '\n' << a.part1 << '\n' << a.part2 << '\n';
+            if (!out) {
+                return;
+            }
+        }
+        std::filesystem::rename(tmp, path_, ec);
+        if (ec) {
+            std::filesystem::remove(tmp, ec);
+        }
+    }
+
+private:
+    static auto directory() -> std::filesystem::path
+    {
+        if (char const* dir = std::getenv("AOC_CACHE_DIR")) {
+            return dir;
+        }
+        if (char const* xdg = std::getenv("XDG_CACHE_HOME")) {
+            return std::filesystem::path(xdg) / "aoc2023";
+        }
+        char const* home = std::getenv("HOME");
+        return std::filesystem::path(home ? home : ".") / ".cache" / "aoc2023";
+    }
+
+    std::string header_;
+    std::filesystem::path path_;
+};
+
+namespace detail {
+
+struct no_streaming {};
+
+template <typename Part1, typename Part2>
+void run_streaming(std::string_view name, streaming_solution<Part1, Part2> const& sol, int fd)
+{
+    phase total(name);
+
+    auto state1 = sol.part1.init;
+    auto state2 = sol.part2.init;
+    {
+        phase p("stream");
+        stream_records(fd, sol.delimiter, [&](std::string_view record) {
+            sol.part1.step(state1, record);
+            sol.part2.step(state2, record);
+        });
+    }
+
+    fmt::println("Part 1: {}", sol.part1.finish(std::move(state1)));
+    fmt::println("Part 2: {}", sol.part2.finish(std::move(state2)));
+}
+
+// The inputs for --batch: each argument names an input file, except that
+// @file names a manifest listing input files, one per line
+inline auto batch_paths(std::vector<std::string_view> const& args) -> std::vector<std::string>
+{
+    std::vector<std::string> paths;
+    for (std::string_view arg : args) {
+        if (!arg.starts_with('@')) {
+            paths.emplace_back(arg);
+            continue;
+        }
+        auto const manifest = mapped_input(std::string(arg.substr(1)).c_str());
+        line_index(manifest.view()).lines()
+            .filter(std::not_fn(flux::is_empty))
+            .for_each([&](std::string_view line) { paths.emplace_back(line); });
+    }
+    return paths;
+}
+
+// Solves every input concurrently on the thread pool, then prints a line of
+// tab-separated path and answers (or "error" and a message) for each, in the
+// order they were given. Inputs are solved a window at a time, while
+// read_files() reads the next window. Each input is handled by a single task,
+// so anything a day keeps thread_local is reused from one input to the next.
+template <typename Parse, typename Part1, typename Part2>
+auto run_batch(std::string_view name, solution<Parse, Part1, Part2> const& sol,
+               std::vector<std::string> const& paths) -> int
+{
+    std::vector<std::string> results(paths.size());
+    std::atomic<bool> failed = false;
+    {
+        phase total(name);
+        phase p("batch");
+
+        auto const window = 2 * static_cast<std::size_t>(default_pool().size());
+        std::vector<file_contents> inputs;
+        std::size_t first = 0; // the index of inputs[0] in paths
+
+        auto const solve_window = [&] {
+            parallel_for(0, flux::size(inputs), [&](std::int64_t i) {
+                auto const& input = inputs[static_cast<std::size_t>(i)];
+                auto const idx = first + static_cast<std::size_t>(i);
+                try {
+                    if (input.error) {
+                        std::rethrow_exception(input.error);
+                    }
+                    auto const state = sol.parse(input.view());
+                    results[idx] = fmt::format("{}\t{}\t{}", paths[idx],
+                                               sol.part1(state), sol.part2(state));
+                } catch (std::exception const& ex) {
+                    results[idx] = fmt::format("{}\terror\t{}", paths[idx], ex.what());
+                    failed = true;
+                }
+            });
+            first += inputs.size();
+            inputs.clear();
+        };
+
+        for (auto& file : read_files(paths, window)) {
+            inputs.push_back(std::move(file));
+            if (inputs.size() == window) {
+                solve_window();
+            }
+        }
+        solve_window();
+    }
+
+    for (auto const& result : results) {
+        fmt::println("{}", result);
+    }
+    if (timings_enabled) {
+        write_timings(stderr);
+    }
+    return failed ? 1 : 0;
+}
+
+#ifdef AOC_EMBEDDED_INPUT
+// The puzzle input, compiled into the executable for days added with
+// add_day(... CONSTEXPR) when AOC_EMBED_INPUTS is set. The build generates the
+// included file as a list of the input's bytes, as C++26's #embed would.
+inline constexpr char embedded_input_bytes[] = {
+#include AOC_EMBEDDED_INPUT
+    0
+};
+
+inline constexpr std::string_view embedded_input{
+    embedded_input_bytes, sizeof(embedded_input_bytes) - 1};
+
+// The members of a solution are all captureless lambdas, so we can make one
+// up inside a constant expression, rather than needing the caller's
+template <typename Sol>
+consteval auto embedded_answers()
+{
+    constexpr Sol sol{};
+    auto const state = sol.parse(embedded_input);
+    return std::pair(sol.part1(state), sol.part2(state));
+}
+#endif
+
+}
+
+// Runs a day's solution on the input file named on the command line, printing
+// the answers. Pass --timings to get a breakdown of where the time went, and
+// --threads N to limit the number of threads used by parallel days. With
+// --cache (or AOC_CACHE set), answers are reused from an earlier run on the
+// same input; --verify-cache (or AOC_CACHE=verify) recomputes them and fails
+// if they differ, and --no-cache ignores AOC_CACHE. --serve <socket> instead
+// answers requests over a socket until killed (see serve()), and --batch
+// solves every input file named (see detail::run_batch()). Days which also
+// pass a streaming_solution read input from stdin ("-") through that, a chunk
+// at a time, rather than loading it all first. When the input was embedded at
+// compile time, running with no input prints the answers the compiler found.
+template <typename Parse, typename Part1, typename Part2,
+          typename Streaming = detail::no_streaming>
+auto run(std::string_view name, solution<Parse, Part1, Part2> const& sol,
+         int argc, char** argv, Streaming const& streaming = {}) -> int
+{
+    char const* path = nullptr;
+    char const* socket_path = nullptr;
+    bool batch = false;
+    std::vector<std::string_view> inputs;
+    if (argc > 0) {
+        detail::exe_path = argv[0];
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        if (arg == "--timings") {
+            detail::timings_enabled = true;
+        } else if (arg == "--perf") {
+            detail::timings_enabled = true;
+            detail::perf_enabled = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            set_thread_count(try_parse<unsigned>(std::string_view(argv[++i])).value_or(1));
+        } else if (arg == "--cache") {
+            detail::answer_cache_mode = detail::cache_mode::on;
+        } else if (arg == "--verify-cache") {
+            detail::answer_cache_mode = detail::cache_mode::verify;
+        } else if (arg == "--no-cache") {
+            detail::answer_cache_mode = detail::cache_mode::off;
+        } else if (arg == "--serve" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (arg == "--batch") {
+            batch = true;
+        } else {
+            path = argv[i];
+            inputs.push_back(arg);
+        }
+    }
+
+    if (socket_path) {
+        return serve({make_day(name, sol)}, socket_path);
+    }
+
+    if (batch) {
+        return detail::run_batch(name, sol, detail::batch_paths(inputs));
+    }
+
+    if (!path) {
+#ifdef AOC_EMBEDDED_INPUT
+        constexpr auto answers = detail::embedded_answers<solution<Parse, Part1, Part2>>();
+        fmt::println("Part 1: {}", answers.first);
+        fmt::println("Part 2: {}", answers.second);
+        return 0;
+#else
+        fmt::println(stderr, "No input");
+        return -1;
+#endif
+    }
+
+    if constexpr (!std::same_as<Streaming, detail::no_streaming>) {
+        if (std::string_view(path) == "-") {
+            detail::run_streaming(name, streaming, STDIN_FILENO);
+            if (detail::timings_enabled) {
+                write_timings(stderr);
+            }
+            return 0;
+        }
+    }
+
+    int status = 0;
+    {
+        phase total(name);
+
+        auto const input = [&] { phase p("load"); return mapped_input(path); }();
+
+        auto const mode = detail::answer_cache_mode;
+        std::optional<answer_cache> cache;
+        std::optional<answer_cache::answers> cached;
+        if (mode != detail::cache_mode::off) {
+            phase p("cache");
+            if (detail::build_id().empty()) {
+                fmt::println(stderr, "Can't identify this executable, so not caching answers");
+            } else {
+                cache.emplace(name, input.view());
+                cached = cache->load();
+            }
+        }
+
+        if (cached && mode == detail::cache_mode::on) {
+            fmt::println("Part 1: {}", cached->part1);
+            fmt::println("Part 2: {}", cached->part2);
+        } else {
+            auto const state = [&] { phase p("parse"); return sol.parse(input.view()); }();
+
+            auto const answer1 = [&] { phase p("part1"); return fmt::format("{}", sol.part1(state)); }();
+            fmt::println("Part 1: {}", answer1);
+
+            auto const answer2 = [&] { phase p("part2"); return fmt::format("{}", sol.part2(state)); }();
+            fmt::println("Part 2: {}", answer2);
+
+            answer_cache::answers const computed{.part1 = answer1, .part2 = answer2};
+            if (cached && *cached != computed) {
+                fmt::println(stderr, "Cached answers differ: Part 1: {}, Part 2: {}",
+                             cached->part1, cached->part2);
+                status = 1;
+            }
+            if (cache) {
+                cache->store(computed);
+            }
+        }
+    }
+
+    if (detail::timings_enabled) {
+        write_timings(stderr);
+    }
+
+    return status;
+}
+
 }
 
 #endif
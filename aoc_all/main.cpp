@@ -0,0 +1,153 @@
+
+#include "../aoc.hpp"
+
+#include <filesystem>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+struct options {
+    fs::path input_dir;
+    std::vector<std::string> days; // empty means all of them
+    std::string socket_path;       // if set, serve requests instead
+};
+
+struct result {
+    std::string part1;
+    std::string part2;
+    std::chrono::microseconds elapsed{};
+    std::string error; // non-empty if the day failed
+};
+
+auto run_day = [](aoc::day const& day, fs::path const& path) -> result
+{
+    result res;
+    aoc::timer t;
+    try {
+        aoc::phase p(day.name);
+        auto const input = aoc::mapped_input(path.c_str());
+        auto const state = day.parse(input);
+        res.part1 = day.part1(state);
+        res.part2 = day.part2(state);
+    } catch (std::exception const& e) {
+        res.error = e.what();
+    }
+    res.elapsed = t.elapsed<std::chrono::microseconds>();
+    return res;
+};
+
+auto parse_args = [](int argc, char** argv) -> std::optional<options>
+{
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&] -> std::string_view {
+            return ++i < argc ? argv[i] : "";
+        };
+
+        if (arg == "--threads") {
+            auto const n = aoc::try_parse<int>(next()).value_or(0);
+            if (n < 1) {
+                return std::nullopt;
+            }
+            aoc::set_thread_count(n);
+        } else if (arg == "--timings") {
+            aoc::detail::timings_enabled = true;
+        } else if (arg == "--day") {
+            opts.days.emplace_back(next());
+        } else if (arg == "--serve") {
+            opts.socket_path = next();
+            if (opts.socket_path.empty()) {
+                return std::nullopt;
+            }
+        } else {
+            opts.input_dir = arg;
+        }
+    }
+
+    if (opts.input_dir.empty() && opts.socket_path.empty()) {
+        return std::nullopt;
+    }
+    return opts;
+};
+
+}
+
+int main(int argc, char** argv)
+{
+    auto const maybe_opts = parse_args(argc, argv);
+    if (!maybe_opts) {
+        fmt::println(stderr, "Usage: aoc_all [--threads N] [--timings] [--day decNN]... <input-dir>\n"
+                             "       aoc_all [--threads N] [--day decNN]... --serve <socket>");
+        return -1;
+    }
+    auto const& opts = *maybe_opts;
+
+    if (!opts.socket_path.empty()) {
+        std::vector<aoc::day> days;
+        for (aoc::day const& day : aoc::registered_days()) {
+            if (opts.days.empty() || flux::contains(opts.days, day.name)) {
+                days.push_back(day);
+            }
+        }
+        return aoc::serve(std::move(days), opts.socket_path.c_str());
+    }
+
+    struct job {
+        aoc::day const* day;
+        fs::path path;
+        result res;
+    };
+
+    std::vector<job> jobs;
+    for (aoc::day const& day : aoc::registered_days()) {
+        if (!opts.days.empty() && !flux::contains(opts.days, day.name)) {
+            continue;
+        }
+
+        // Inputs are expected to be named after the day, e.g. dec01.txt
+        auto path = opts.input_dir / (day.name + ".txt");
+        if (!fs::exists(path)) {
+            fmt::println(stderr, "Skipping {}: {} not found", day.name, path.string());
+            continue;
+        }
+        jobs.push_back(job{.day = &day, .path = std::move(path), .res = {}});
+    }
+
+    // Start the slowest days first, so that one of them isn't left running on
+    // its own at the end. Days which use the pool themselves share it with
+    // the others.
+    flux::sort(jobs, [](job const& lhs, job const& rhs) {
+        return lhs.day->cost > rhs.day->cost;
+    });
+
+    aoc::timer total;
+    aoc::parallel_for(0, flux::size(jobs), [&](std::int64_t i) {
+        jobs[i].res = run_day(*jobs[i].day, jobs[i].path);
+    });
+    auto const total_time = total.elapsed<std::chrono::microseconds>();
+
+    flux::sort(jobs, [](job const& lhs, job const& rhs) {
+        return lhs.day->name < rhs.day->name;
+    });
+
+    int failures = 0;
+    for (job const& j : jobs) {
+        if (!j.res.error.empty()) {
+            fmt::println("{}: error: {}", j.day->name, j.res.error);
+            ++failures;
+        } else {
+            fmt::println("{}: Part 1: {:<16} Part 2: {:<16} ({} us)",
+                         j.day->name, j.res.part1, j.res.part2, j.res.elapsed.count());
+        }
+    }
+    fmt::println("{} days in {} us using {} threads",
+                 jobs.size(), total_time.count(), aoc::default_pool().size());
+
+    if (aoc::detail::timings_enabled) {
+        aoc::write_timings(stderr);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
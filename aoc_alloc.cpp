@@ -0,0 +1,123 @@
+
+// Replacement global operator new and delete which keep count of heap
+// allocations, for aoc::alloc_scope. Only linked in when configured with
+// -DAOC_TRACK_ALLOCS=ON.
+
+#include "aoc_alloc.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+namespace {
+
+auto usable_size(void* ptr) -> std::int64_t
+{
+#if defined(__APPLE__)
+    return static_cast<std::int64_t>(::malloc_size(ptr));
+#else
+    return static_cast<std::int64_t>(::malloc_usable_size(ptr));
+#endif
+}
+
+auto track_alloc(void* ptr, std::size_t size) -> void*
+{
+    if (ptr) {
+        auto& allocs = aoc::detail::allocs;
+        allocs.count.fetch_add(1, std::memory_order_relaxed);
+        allocs.bytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+        auto live = usable_size(ptr) +
+                    allocs.live.fetch_add(usable_size(ptr), std::memory_order_relaxed);
+        aoc::detail::raise_peak(live);
+    }
+    return ptr;
+}
+
+void track_free(void* ptr)
+{
+    if (ptr) {
+        aoc::detail::allocs.live.fetch_sub(usable_size(ptr), std::memory_order_relaxed);
+        std::free(ptr);
+    }
+}
+
+auto allocate(std::size_t size) -> void*
+{
+    return track_alloc(std::malloc(size == 0 ? 1 : size), size);
+}
+
+auto allocate_aligned(std::size_t size, std::align_val_t align) -> void*
+{
+    auto const alignment = static_cast<std::size_t>(align);
+    // aligned_alloc() requires the size to be a multiple of the alignment
+    auto const rounded = (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment;
+    return track_alloc(std::aligned_alloc(alignment, rounded), size);
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* ptr = allocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    if (void* ptr = allocate_aligned(size, align)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+    return ::operator new(size, align);
+}
+
+void* operator new(std::size_t size, std::align_val_t align, std::nothrow_t const&) noexcept
+{
+    return allocate_aligned(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align, std::nothrow_t const&) noexcept
+{
+    return allocate_aligned(size, align);
+}
+
+void operator delete(void* ptr) noexcept { track_free(ptr); }
+void operator delete[](void* ptr) noexcept { track_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { track_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { track_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { track_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { track_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { track_free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { track_free(ptr); }
+void operator delete(void* ptr, std::nothrow_t const&) noexcept { track_free(ptr); }
+void operator delete[](void* ptr, std::nothrow_t const&) noexcept { track_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, std::nothrow_t const&) noexcept { track_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, std::nothrow_t const&) noexcept { track_free(ptr); }
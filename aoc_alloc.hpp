@@ -0,0 +1,30 @@
+#ifndef AOC_ALLOC_HPP_INCLUDED
+#define AOC_ALLOC_HPP_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+
+namespace aoc::detail {
+
+// Heap allocation counters, kept up to date by the replacement operator new
+// and delete in aoc_alloc.cpp (when it's linked in) and read by alloc_scope
+
+struct alloc_counters {
+    std::atomic<std::int64_t> count{0};
+    std::atomic<std::int64_t> bytes{0};
+    std::atomic<std::int64_t> live{0};
+    std::atomic<std::int64_t> peak{0};
+};
+
+inline alloc_counters allocs;
+
+inline void raise_peak(std::int64_t value)
+{
+    auto cur = allocs.peak.load(std::memory_order_relaxed);
+    while (cur < value &&
+           !allocs.peak.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+}
+
+}
+
+#endif
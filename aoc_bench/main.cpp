@@ -0,0 +1,390 @@
+
+#include "../aoc.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#include <ctre.hpp>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+using duration = std::chrono::nanoseconds;
+
+struct options {
+    fs::path input_dir;
+    int reps = 10;
+    int warmup = 1;
+    std::vector<std::string> days; // empty means all of them
+    std::string lines_file; // run the line-splitting microbenchmark instead
+    fs::path save_file; // write the results here as a baseline
+    fs::path baseline_file; // compare the results against this baseline
+    int threshold = 5; // smallest change in median worth reporting (%)
+};
+
+struct summary {
+    duration min;
+    duration median;
+    duration p99;
+    duration mad; // median absolute deviation from the median
+};
+
+auto summarise = [](std::vector<duration> samples) -> summary
+{
+    flux::sort(samples);
+    auto const n = flux::size(samples);
+    auto const p99_idx = std::max<std::ptrdiff_t>(0, (99 * n + 99)/100 - 1);
+    auto const median = samples.at(n/2);
+
+    std::vector<duration> deviations;
+    deviations.reserve(n);
+    for (duration d : samples) {
+        deviations.push_back(d > median ? d - median : median - d);
+    }
+    flux::sort(deviations);
+
+    return summary{
+        .min = samples.front(),
+        .median = median,
+        .p99 = samples.at(p99_idx),
+        .mad = deviations.at(n/2)
+    };
+};
+
+// All the timings for one phase of one day
+struct result {
+    std::string day;
+    std::string phase;
+    std::vector<duration> samples;
+};
+
+auto no_setup = [] {};
+
+// Calls fn() reps times, returning the time taken by each call. setup() is
+// called before each one, outside the timed section.
+auto time_reps = [](int reps, auto&& fn, auto&& setup) -> std::vector<duration>
+{
+    std::vector<duration> samples;
+    samples.reserve(reps);
+    for (auto _ : flux::ints(0, reps)) {
+        setup();
+        aoc::timer t;
+        fn();
+        samples.push_back(t.elapsed<duration>());
+    }
+    return samples;
+};
+
+auto print_summary = [](std::string_view day, std::string_view phase, summary const& s)
+{
+    auto as_us = [](duration d) {
+        return std::chrono::duration<double, std::micro>(d).count();
+    };
+    fmt::println("{:<6} {:<6} {:>14.1f} {:>14.1f} {:>14.1f}",
+                 day, phase, as_us(s.min), as_us(s.median), as_us(s.p99));
+};
+
+auto bench_day = [](aoc::day const& day, std::string_view input, options const& opts)
+    -> std::vector<result>
+{
+    for (auto _ : flux::ints(0, opts.warmup)) {
+        auto state = day.parse(input);
+        day.part1(state);
+        day.part2(state);
+    }
+
+    // The last rep's state is freed before timing the next parse, so that
+    // tearing it down isn't counted as parsing
+    aoc::day::state_t state;
+    auto parse_times = time_reps(opts.reps, [&] { state = day.parse(input); },
+                                 [&] { state.reset(); });
+    auto part1_times = time_reps(opts.reps, [&] { day.part1(state); }, no_setup);
+    auto part2_times = time_reps(opts.reps, [&] { day.part2(state); }, no_setup);
+
+    std::vector<result> results{
+        {day.name, "parse", std::move(parse_times)},
+        {day.name, "part1", std::move(part1_times)},
+        {day.name, "part2", std::move(part2_times)}
+    };
+    for (result const& r : results) {
+        print_summary(r.day, r.phase, summarise(r.samples));
+    }
+    return results;
+};
+
+// Baselines are JSON, with each phase on a line of its own so that reading
+// them back (which only needs to understand what we write) is easy
+auto save_baseline = [](fs::path const& path, std::vector<result> const& results)
+{
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error(fmt::format("Could not write {}", path.string()));
+    }
+
+    out << "{\"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        auto const& r = results[i];
+        auto const s = summarise(r.samples);
+        std::vector<std::int64_t> ns;
+        for (duration d : r.samples) {
+            ns.push_back(d.count());
+        }
+        out << fmt::format(R"(  {{"day": "{}", "phase": "{}", "min_ns": {}, "median_ns": {}, )"
+                           R"("p99_ns": {}, "mad_ns": {}, "samples_ns": [{}]}}{})",
+                           r.day, r.phase, s.min.count(), s.median.count(),
+                           s.p99.count(), s.mad.count(), fmt::join(ns, ", "),
+                           i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+};
+
+auto load_baseline = [](fs::path const& path) -> std::vector<result>
+{
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error(fmt::format("Could not read {}", path.string()));
+    }
+
+    constexpr auto& line_regex =
+        ctre::search<R"re("day": "(\w+)", "phase": "(\w+)".*"samples_ns": \[([^\]]*)\])re">;
+
+    std::vector<result> results;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (auto [m, day, phase, samples] = line_regex(line); m) {
+            std::vector<std::int64_t> ns;
+            aoc::parse_all<std::int64_t>(samples.view(), std::back_inserter(ns));
+            results.push_back({day.str(), phase.str(),
+                               flux::map(ns, [](auto n) { return duration(n); })
+                                   .to<std::vector>()});
+        }
+    }
+    return results;
+};
+
+// Two-sided Mann-Whitney U test of whether two sets of samples could have come
+// from the same distribution, returning the p-value. This uses the normal
+// approximation (corrected for ties), which is fair from about 8 samples each.
+// Unlike comparing means, one unlucky rep can't make much difference.
+auto mann_whitney = [](std::vector<duration> const& a, std::vector<duration> const& b) -> double
+{
+    double const n1 = double(a.size());
+    double const n2 = double(b.size());
+    double const n = n1 + n2;
+
+    // Rank all the samples together, tied samples sharing the mean of their ranks
+    std::vector<std::pair<duration, bool>> all; // (sample, is from a)
+    all.reserve(a.size() + b.size());
+    for (duration d : a) { all.emplace_back(d, true); }
+    for (duration d : b) { all.emplace_back(d, false); }
+    flux::sort(all);
+
+    double rank_sum_a = 0;
+    double ties = 0;
+    for (std::size_t i = 0; i < all.size(); ) {
+        std::size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) {
+            ++j;
+        }
+        double const rank = double(i + j + 1) / 2.0;
+        for (std::size_t k = i; k < j; ++k) {
+            rank_sum_a += all[k].second ? rank : 0.0;
+        }
+        double const t = double(j - i);
+        ties += t * t * t - t;
+        i = j;
+    }
+
+    double const u = rank_sum_a - n1 * (n1 + 1) / 2;
+    double const mean = n1 * n2 / 2;
+    double const variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+    if (variance <= 0) {
+        return 1.0;
+    }
+    double const z = std::max(0.0, std::abs(u - mean) - 0.5) / std::sqrt(variance);
+    return std::erfc(z / std::sqrt(2.0));
+};
+
+constexpr double significance = 0.01;
+
+// Prints how each phase has changed since the baseline, returning the number
+// of phases which are significantly slower. A change is only reported if the
+// samples differ at the significance level above *and* the median has moved by
+// more than the threshold, so that small but consistent differences (from code
+// layout, say) don't get flagged.
+auto compare_baseline = [](std::vector<result> const& baseline,
+                           std::vector<result> const& results,
+                           options const& opts) -> int
+{
+    auto as_us = [](duration d) {
+        return std::chrono::duration<double, std::micro>(d).count();
+    };
+
+    fmt::println("\n{:<6} {:<6} {:>14} {:>14} {:>9} {:>9}  {}",
+                 "day", "phase", "base (us)", "median (us)", "change", "p", "verdict");
+
+    int regressions = 0;
+    for (result const& r : results) {
+        auto const base = flux::find_if(baseline, [&r](result const& b) {
+            return b.day == r.day && b.phase == r.phase;
+        });
+        if (base == flux::size(baseline)) {
+            fmt::println("{:<6} {:<6} {:>14} {:>14.1f} {:>9} {:>9}  no baseline",
+                         r.day, r.phase, "-", as_us(summarise(r.samples).median), "-", "-");
+            continue;
+        }
+
+        auto const& base_samples = baseline.at(base).samples;
+        auto const old_median = summarise(base_samples).median;
+        auto const new_median = summarise(r.samples).median;
+        double const change = old_median.count() == 0 ? 0.0
+            : 100.0 * double((new_median - old_median).count()) / double(old_median.count());
+        double const p = mann_whitney(base_samples, r.samples);
+
+        std::string_view verdict = "";
+        if (p < significance && change > opts.threshold) {
+            verdict = "SLOWER";
+            ++regressions;
+        } else if (p < significance && change < -opts.threshold) {
+            verdict = "faster";
+        }
+
+        fmt::println("{:<6} {:<6} {:>14.1f} {:>14.1f} {:>+8.1f}% {:>9.4f}  {}",
+                     r.day, r.phase, as_us(old_median), as_us(new_median),
+                     change, p, verdict);
+    }
+    return regressions;
+};
+
+// Compares splitting a (large) file into lines with flux::split_string()
+// against building an aoc::line_index, in each case counting the non-empty
+// lines as most of the parsers do
+auto bench_lines = [](std::string_view input, options const& opts)
+{
+    auto is_nonempty = [](std::string_view line) { return !line.empty(); };
+
+    auto count_split = [&] {
+        return flux::split_string(input, '\n').filter(is_nonempty).count();
+    };
+    auto count_index = [&] {
+        return aoc::line_index(input).lines().filter(is_nonempty).count();
+    };
+
+    if (count_split() != count_index()) {
+        throw std::runtime_error("split_string and line_index disagree!");
+    }
+
+    auto report = [&](std::string_view name, std::vector<duration> samples) {
+        auto s = summarise(std::move(samples));
+        auto gb_per_s = double(input.size()) / double(s.median.count());
+        fmt::println("{:<12} {:>14.1f} {:>14.1f} {:>14.1f} {:>10.2f}", name,
+                     std::chrono::duration<double, std::milli>(s.min).count(),
+                     std::chrono::duration<double, std::milli>(s.median).count(),
+                     std::chrono::duration<double, std::milli>(s.p99).count(),
+                     gb_per_s);
+    };
+
+    fmt::println("{} bytes, {} non-empty lines", input.size(), count_index());
+    fmt::println("{:<12} {:>14} {:>14} {:>14} {:>10}",
+                 "method", "min (ms)", "median (ms)", "p99 (ms)", "GB/s");
+    report("split_string", time_reps(opts.reps, count_split, no_setup));
+    report("line_index", time_reps(opts.reps, count_index, no_setup));
+};
+
+auto parse_args = [](int argc, char** argv) -> std::optional<options>
+{
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&] -> std::string_view {
+            return ++i < argc ? argv[i] : "";
+        };
+
+        if (arg == "--reps") {
+            opts.reps = aoc::try_parse<int>(next()).value_or(0);
+        } else if (arg == "--warmup") {
+            opts.warmup = aoc::try_parse<int>(next()).value_or(-1);
+        } else if (arg == "--day") {
+            opts.days.emplace_back(next());
+        } else if (arg == "--lines") {
+            opts.lines_file = next();
+        } else if (arg == "--save") {
+            opts.save_file = next();
+        } else if (arg == "--compare") {
+            opts.baseline_file = next();
+        } else if (arg == "--threshold") {
+            opts.threshold = aoc::try_parse<int>(next()).value_or(-1);
+        } else {
+            opts.input_dir = arg;
+        }
+    }
+
+    if ((opts.input_dir.empty() && opts.lines_file.empty()) ||
+        opts.reps < 1 || opts.warmup < 0 || opts.threshold < 0) {
+        return std::nullopt;
+    }
+    return opts;
+};
+
+}
+
+int main(int argc, char** argv)
+{
+    auto const maybe_opts = parse_args(argc, argv);
+    if (!maybe_opts) {
+        fmt::println(stderr, "Usage: aoc_bench [--reps N] [--warmup N] [--day decNN]...\n"
+                             "                 [--save <file>] [--compare <file> [--threshold PCT]] <input-dir>");
+        fmt::println(stderr, "       aoc_bench [--reps N] --lines <file>");
+        return -1;
+    }
+    auto const& opts = *maybe_opts;
+
+    if (!opts.lines_file.empty()) {
+        auto const input = aoc::mapped_input(opts.lines_file.c_str());
+        bench_lines(input, opts);
+        return 0;
+    }
+
+    auto days = aoc::registered_days();
+    flux::sort(days, [](auto const& lhs, auto const& rhs) { return lhs.name < rhs.name; });
+
+    // Load the baseline first, so that we don't spend ages benchmarking only
+    // to find that it's missing
+    auto const baseline = opts.baseline_file.empty()
+        ? std::vector<result>{} : load_baseline(opts.baseline_file);
+
+    fmt::println("{:<6} {:<6} {:>14} {:>14} {:>14}",
+                 "day", "phase", "min (us)", "median (us)", "p99 (us)");
+
+    std::vector<result> results;
+    for (aoc::day const& day : days) {
+        if (!opts.days.empty() && !flux::contains(opts.days, day.name)) {
+            continue;
+        }
+
+        // Inputs are expected to be named after the day, e.g. dec01.txt
+        auto const path = opts.input_dir / (day.name + ".txt");
+        if (!fs::exists(path)) {
+            fmt::println(stderr, "Skipping {}: {} not found", day.name, path.string());
+            continue;
+        }
+
+        auto const input = aoc::mapped_input(path.c_str());
+        std::ranges::move(bench_day(day, input, opts), std::back_inserter(results));
+    }
+
+    if (!opts.save_file.empty()) {
+        save_baseline(opts.save_file, results);
+    }
+
+    if (!opts.baseline_file.empty()) {
+        int const regressions = compare_baseline(baseline, results, opts);
+        if (regressions > 0) {
+            fmt::println(stderr, "{} phase(s) slower than the baseline", regressions);
+            return 1;
+        }
+    }
+}
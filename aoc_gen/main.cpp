@@ -0,0 +1,943 @@
+
+#include "../aoc.hpp"
+
+#include <filesystem>
+#include <random>
+#include <set>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+using i64 = std::int64_t;
+using rng_t = std::mt19937_64;
+
+/*
+ * Helpers
+ */
+
+// std::uniform_int_distribution and std::shuffle are allowed to give different
+// results with different standard libraries, so we use our own versions to
+// make sure a given seed always produces the same inputs
+auto uniform = [](rng_t& rng, i64 lo, i64 hi) -> i64 {
+    return lo + static_cast<i64>(rng() % static_cast<std::uint64_t>(hi - lo + 1));
+};
+
+auto chance = [](rng_t& rng, double p) -> bool {
+    return double(rng() >> 11) * 0x1.0p-53 < p;
+};
+
+auto pick = [](rng_t& rng, std::string_view chars) -> char {
+    return chars[uniform(rng, 0, i64(chars.size()) - 1)];
+};
+
+auto shuffle = [](rng_t& rng, auto& vec) {
+    for (i64 i = i64(vec.size()) - 1; i > 0; --i) {
+        std::swap(vec[i], vec[uniform(rng, 0, i)]);
+    }
+};
+
+auto is_prime = [](i64 n) -> bool {
+    if (n < 2) {
+        return false;
+    }
+    for (i64 d = 2; d * d <= n; ++d) {
+        if (n % d == 0) {
+            return false;
+        }
+    }
+    return true;
+};
+
+// A random prime in [lo, hi] which isn't already in used
+auto random_prime = [](rng_t& rng, i64 lo, i64 hi, std::vector<i64>& used) -> i64 {
+    while (true) {
+        i64 n = uniform(rng, lo, hi);
+        if (is_prime(n) && !flux::contains(used, n)) {
+            used.push_back(n);
+            return n;
+        }
+    }
+};
+
+// A width x height grid, with each tile chosen by calling cell(x, y)
+auto make_grid = [](i64 width, i64 height, auto&& cell) -> std::string {
+    std::string out;
+    out.reserve((width + 1) * height);
+    for (i64 y = 0; y < height; ++y) {
+        for (i64 x = 0; x < width; ++x) {
+            out.push_back(cell(x, y));
+        }
+        out.push_back('\n');
+    }
+    return out;
+};
+
+// A random region of an n x n grid of cells, grown outwards from the centre.
+// A cell is only added if the existing cells around it form a single run (so
+// no holes can appear) and it doesn't leave two cells touching only at a
+// corner, which means the outline of the region is always a simple loop.
+struct region {
+    i64 n;
+    std::vector<bool> cells;
+
+    auto operator()(i64 x, i64 y) const -> bool
+    {
+        return x >= 0 && y >= 0 && x < n && y < n && cells[y * n + x];
+    }
+};
+
+auto grow_region = [](rng_t& rng, i64 n, double fill) -> region
+{
+    region r{.n = n, .cells = std::vector<bool>(n * n, false)};
+
+    constexpr std::array<std::pair<i64, i64>, 8> ring{{
+        {0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
+    }};
+
+    auto can_add = [&](i64 x, i64 y) {
+        int runs = 0;
+        for (auto i : flux::ints(0, 8)) {
+            auto [dx, dy] = ring[i];
+            auto [px, py] = ring[(i + 7) % 8];
+            runs += r(x + dx, y + dy) && !r(x + px, y + py);
+        }
+        if (runs != 1) {
+            return false;
+        }
+        for (auto [dx, dy] : {std::pair<i64, i64>{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}) {
+            if (r(x + dx, y + dy) && !r(x + dx, y) && !r(x, y + dy)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<std::pair<i64, i64>> frontier;
+    auto add = [&](i64 x, i64 y) {
+        r.cells[y * n + x] = true;
+        frontier.insert(frontier.end(), {{x, y - 1}, {x + 1, y}, {x, y + 1}, {x - 1, y}});
+    };
+
+    add(n/2, n/2);
+    i64 count = 1;
+    i64 const target = i64(fill * double((n - 2) * (n - 2)));
+
+    while (count < target && !frontier.empty()) {
+        std::swap(frontier[uniform(rng, 0, i64(frontier.size()) - 1)], frontier.back());
+        auto [x, y] = frontier.back();
+        frontier.pop_back();
+
+        // Keep away from the edges so there's always a gap around the region
+        if (x < 1 || y < 1 || x > n - 2 || y > n - 2 || r(x, y) || !can_add(x, y)) {
+            continue;
+        }
+        add(x, y);
+        ++count;
+    }
+
+    return r;
+};
+
+// The corners visited going clockwise around the outline of a region, in an
+// (n+1) x (n+1) grid of vertices. The first vertex is the region's top-left
+// corner, so the outline starts by heading east after arriving from the south.
+auto outline = [](region const& r) -> std::vector<std::pair<i64, i64>>
+{
+    // Whether there is an edge of the outline leading from vertex (x, y) in
+    // the direction (dx, dy)
+    auto has_edge = [&r](i64 x, i64 y, i64 dx, i64 dy) {
+        if (dx == 1) { return r(x, y - 1) != r(x, y); }
+        if (dx == -1) { return r(x - 1, y - 1) != r(x - 1, y); }
+        if (dy == 1) { return r(x - 1, y) != r(x, y); }
+        return r(x - 1, y - 1) != r(x, y - 1);
+    };
+
+    auto const start_idx = std::ranges::find(r.cells, true) - r.cells.begin();
+    std::pair<i64, i64> const start{start_idx % r.n, start_idx / r.n};
+
+    std::vector<std::pair<i64, i64>> verts{start};
+    auto [x, y] = start;
+    std::pair<i64, i64> dir{1, 0};
+
+    while (true) {
+        x += dir.first;
+        y += dir.second;
+        if (std::pair(x, y) == start) {
+            break;
+        }
+        verts.emplace_back(x, y);
+
+        // Each vertex has exactly two edges, so take the one which doesn't
+        // lead back where we came from
+        for (auto next : {std::pair<i64, i64>{1, 0}, {0, 1}, {-1, 0}, {0, -1}}) {
+            if (next != std::pair(-dir.first, -dir.second) &&
+                has_edge(x, y, next.first, next.second)) {
+                dir = next;
+                break;
+            }
+        }
+    }
+
+    return verts;
+};
+
+/*
+ * Generators
+ *
+ * Each of these produces an input for one day, roughly the size of a real
+ * puzzle input when scale is 1. Where a solution relies on some property of
+ * the real inputs, the generated inputs have it too.
+ */
+
+auto gen_dec01 = [](rng_t& rng, i64 scale) -> std::string
+{
+    constexpr std::array<std::string_view, 9> words{
+        "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"
+    };
+
+    std::string out;
+    for (auto _ : flux::ints(0, 1000 * scale)) {
+        std::string line;
+        auto const len = uniform(rng, 5, 40);
+        while (i64(line.size()) < len) {
+            if (chance(rng, 0.15)) {
+                line.push_back(pick(rng, "123456789"));
+            } else if (chance(rng, 0.1)) {
+                line += words[uniform(rng, 0, 8)];
+            } else {
+                line.push_back(pick(rng, "abcdefghijklmnopqrstuvwxyz"));
+            }
+        }
+        // Every line needs at least one real digit for part 1
+        if (line.find_first_of("0123456789") == std::string::npos) {
+            line.insert(line.begin() + uniform(rng, 0, i64(line.size())),
+                        pick(rng, "123456789"));
+        }
+        out += line;
+        out.push_back('\n');
+    }
+    return out;
+};
+
+auto gen_dec02 = [](rng_t& rng, i64 scale) -> std::string
+{
+    constexpr std::array<std::string_view, 3> colours{"red", "green", "blue"};
+
+    std::string out;
+    auto it = std::back_inserter(out);
+    for (auto id : flux::ints(1, 100 * scale + 1)) {
+        fmt::format_to(it, "Game {}: ", id);
+        auto const n_draws = uniform(rng, 1, 6);
+        for (auto d : flux::ints(0, n_draws)) {
+            auto order = std::array{0, 1, 2};
+            shuffle(rng, order);
+            auto const n_colours = uniform(rng, 1, 3);
+            for (auto c : flux::ints(0, n_colours)) {
+                fmt::format_to(it, "{} {}{}", uniform(rng, 1, 20), colours[order[c]],
+                               c + 1 < n_colours ? ", " : "");
+            }
+            out += d + 1 < n_draws ? "; " : "\n";
+        }
+    }
+    return out;
+};
+
+auto gen_dec03 = [](rng_t& rng, i64 scale) -> std::string
+{
+    constexpr i64 width = 140;
+
+    std::string out;
+    for (auto _ : flux::ints(0, 140 * scale)) {
+        std::string line;
+        while (i64(line.size()) < width) {
+            bool const after_digit = !line.empty() && line.back() >= '0' && line.back() <= '9';
+            auto const num = fmt::format("{}", uniform(rng, 1, 999));
+            if (!after_digit && chance(rng, 0.1) && i64(line.size() + num.size()) <= width) {
+                line += num;
+            } else if (chance(rng, 0.06)) {
+                line.push_back(pick(rng, "*#+$/@=%&-"));
+            } else {
+                line.push_back('.');
+            }
+        }
+        out += line;
+        out.push_back('\n');
+    }
+    return out;
+};
+
+auto gen_dec04 = [](rng_t& rng, i64 scale) -> std::string
+{
+    i64 const n_cards = 200 * scale;
+
+    std::string out;
+    auto it = std::back_inserter(out);
+    for (auto idx : flux::ints(0, n_cards)) {
+        std::vector<int> nums = flux::ints(1, 100).map([](i64 i) { return int(i); })
+                                    .to<std::vector>();
+        shuffle(rng, nums);
+
+        // Part 2 would run off the end if a card won copies of cards which
+        // don't exist
+        auto const matches = uniform(rng, 0, std::min<i64>(10, n_cards - 1 - idx));
+
+        std::vector<int> have(nums.begin() + 10 - matches, nums.begin() + 35 - matches);
+        shuffle(rng, have);
+
+        fmt::format_to(it, "Card {:>3}: {:>2} | {:>2}\n", idx + 1,
+                       fmt::join(nums.begin(), nums.begin() + 10, " "),
+                       fmt::join(have, " "));
+    }
+    return out;
+};
+
+auto gen_dec05 = [](rng_t& rng, i64 scale) -> std::string
+{
+    constexpr i64 max_value = i64{1} << 32;
+    constexpr std::array<std::string_view, 7> names{
+        "seed-to-soil", "soil-to-fertilizer", "fertilizer-to-water",
+        "water-to-light", "light-to-temperature", "temperature-to-humidity",
+        "humidity-to-location"
+    };
+
+    std::string out = "seeds:";
+    auto it = std::back_inserter(out);
+
+    // Part 2 checks every seed, so the lengths of the ranges are what scale
+    for (auto _ : flux::ints(0, 10)) {
+        auto const len = std::min(uniform(rng, 100'000'000, 300'000'000) * scale,
+                                  max_value / 2);
+        fmt::format_to(it, " {} {}", uniform(rng, 0, max_value - len), len);
+    }
+    out += "\n";
+
+    // Each map shuffles the intervals between some random cut points, so it's
+    // a one-to-one mapping just like the real ones
+    for (auto name : names) {
+        std::set<i64> cut_set;
+        auto const n_entries = uniform(rng, 10, 40);
+        while (i64(cut_set.size()) < n_entries + 1) {
+            cut_set.insert(uniform(rng, 0, max_value));
+        }
+        std::vector<i64> cuts(cut_set.begin(), cut_set.end());
+
+        std::vector<i64> order = flux::ints(0, n_entries).to<std::vector<i64>>();
+        shuffle(rng, order);
+
+        std::vector<std::string> entries;
+        i64 dest = cuts.front();
+        for (auto i : order) {
+            auto const len = cuts[i + 1] - cuts[i];
+            entries.push_back(fmt::format("{} {} {}", dest, cuts[i], len));
+            dest += len;
+        }
+        shuffle(rng, entries);
+
+        fmt::format_to(it, "\n{} map:\n{}\n", name, fmt::join(entries, "\n"));
+    }
+    return out;
+};
+
+// The puzzle only ever has a handful of races, and part 2 glues their numbers
+// together, so this one can't usefully be scaled
+auto gen_dec06 = [](rng_t& rng, i64) -> std::string
+{
+    while (true) {
+        std::array<i64, 4> times{};
+        std::array<i64, 4> dists{};
+        for (auto i : flux::ints(0, 4)) {
+            times[i] = uniform(rng, 30, 99);
+            dists[i] = uniform(rng, times[i], times[i] * times[i] / 4 - 1);
+        }
+
+        // Part 2 needs the combined race to be winnable too
+        auto const big_time = aoc::parse<i64>(fmt::format("{}", fmt::join(times, "")));
+        auto const big_dist = aoc::parse<i64>(fmt::format("{}", fmt::join(dists, "")));
+        if (4 * big_dist < big_time * big_time) {
+            return fmt::format("Time:     {:>5}\nDistance: {:>5}\n",
+                               fmt::join(times, " "), fmt::join(dists, " "));
+        }
+    }
+};
+
+auto gen_dec07 = [](rng_t& rng, i64 scale) -> std::string
+{
+    std::string out;
+    auto it = std::back_inserter(out);
+    for (auto _ : flux::ints(0, 1000 * scale)) {
+        auto const hand = std::array{pick(rng, "23456789TJQKA"), pick(rng, "23456789TJQKA"),
+                                     pick(rng, "23456789TJQKA"), pick(rng, "23456789TJQKA"),
+                                     pick(rng, "23456789TJQKA")};
+        fmt::format_to(it, "{} {}\n", std::string_view(hand.data(), hand.size()),
+                       uniform(rng, 1, 1000));
+    }
+    return out;
+};
+
+// Each ghost follows its own loop, whose length is the distance from its
+// starting node to its end node, so that part 2's LCM gives the right answer
+auto gen_dec08 = [](rng_t& rng, i64 scale) -> std::string
+{
+    constexpr i64 n_ghosts = 6;
+
+    std::string out;
+    for (auto _ : flux::ints(0, uniform(rng, 250, 300))) {
+        out.push_back(pick(rng, "LR"));
+    }
+    out += "\n\n";
+
+    // Names for all the nodes in between, which mustn't end in A or Z
+    std::vector<std::string> names;
+    for (char a = 'A'; a <= 'Z'; ++a) {
+        for (char b = 'A'; b <= 'Z'; ++b) {
+            for (char c = 'B'; c < 'Z'; ++c) {
+                names.push_back({a, b, c});
+            }
+        }
+    }
+    shuffle(rng, names);
+
+    // The LCM of the loop lengths must fit in an i64, and there must be
+    // enough names to go round
+    i64 const max_len = std::min<i64>(60 * scale, 1300);
+    std::vector<i64> used;
+    std::vector<std::string> lines;
+    std::set<std::string> prefixes{"AA", "ZZ"};
+
+    for (auto g : flux::ints(0, n_ghosts)) {
+        std::string prefix = "AA";
+        while (g > 0 && !prefixes.insert(prefix).second) {
+            prefix = {pick(rng, "ABCDEFGHIJKLMNOPQRSTUVWXYZ"), pick(rng, "ABCDEFGHIJKLMNOPQRSTUVWXYZ")};
+        }
+        auto const start = prefix + 'A';
+        auto const end = (g == 0 ? std::string("ZZ") : prefix) + 'Z';
+
+        auto const len = random_prime(rng, max_len / 2, max_len, used);
+        std::vector<std::string> path{start};
+        for (auto _ : flux::ints(1, len)) {
+            path.push_back(std::move(names.back()));
+            names.pop_back();
+        }
+        path.push_back(end);
+
+        for (auto i : flux::ints(0, len)) {
+            lines.push_back(fmt::format("{0} = ({1}, {1})", path[i], path[i + 1]));
+        }
+        lines.push_back(fmt::format("{0} = ({1}, {1})", end, path[1]));
+    }
+    shuffle(rng, lines);
+
+    out += fmt::format("{}\n", fmt::join(lines, "\n"));
+    return out;
+};
+
+// Sequences generated by polynomials, so that they always reach all zeros
+auto gen_dec09 = [](rng_t& rng, i64 scale) -> std::string
+{
+    std::string out;
+    auto it = std::back_inserter(out);
+    for (auto _ : flux::ints(0, 200 * scale)) {
+        std::vector<i64> diffs(uniform(rng, 1, 7));
+        for (i64& d : diffs) {
+            d = uniform(rng, -8, 8);
+        }
+
+        std::vector<i64> values;
+        for (auto n : flux::ints(0, 21)) {
+            i64 value = 0;
+            i64 binom = 1;
+            for (auto k : flux::ints(0, flux::size(diffs))) {
+                value += binom * diffs[k];
+                binom = binom * (n - k) / (k + 1);
+            }
+            values.push_back(value);
+        }
+        fmt::format_to(it, "{}\n", fmt::join(values, " "));
+    }
+    return out;
+};
+
+// A square grid containing a single loop, with S on its top-left corner (part
+// 2 assumes S is an F) and junk pipes everywhere else
+auto gen_dec10 = [](rng_t& rng, i64 scale) -> std::string
+{
+    i64 const size = 140 * scale;
+    auto const loop = outline(grow_region(rng, size - 1, 0.4));
+
+    std::string tiles = make_grid(size, size, [&](i64, i64) {
+        return chance(rng, 0.3) ? '.' : pick(rng, "|-LJ7F");
+    });
+    auto at = [&](i64 x, i64 y) -> char& { return tiles.at(y * (size + 1) + x); };
+
+    auto const n = flux::size(loop);
+    for (auto i : flux::ints(0, n)) {
+        auto [x, y] = loop[i];
+        auto [px, py] = loop[(i + n - 1) % n];
+        auto [nx, ny] = loop[(i + 1) % n];
+
+        bool const north = py < y || ny < y;
+        bool const south = py > y || ny > y;
+        bool const east = px > x || nx > x;
+        bool const west = px < x || nx < x;
+
+        at(x, y) = north && south ? '|'
+                 : east && west   ? '-'
+                 : north && east  ? 'L'
+                 : north && west  ? 'J'
+                 : south && west  ? '7'
+                                  : 'F';
+    }
+
+    // Make sure the only pipes leading into S are the ones on the loop
+    auto [sx, sy] = loop.front();
+    at(sx, sy) = 'S';
+    if (sy > 0) { at(sx, sy - 1) = '.'; }
+    if (sx > 0) { at(sx - 1, sy) = '.'; }
+
+    return tiles;
+};
+
+auto gen_dec11 = [](rng_t& rng, i64 scale) -> std::string
+{
+    i64 const size = 140 * scale;
+
+    std::vector<bool> empty_rows(size);
+    std::vector<bool> empty_cols(size);
+    for (auto i : flux::ints(0, size)) {
+        empty_rows[i] = chance(rng, 0.05);
+        empty_cols[i] = chance(rng, 0.05);
+    }
+
+    return make_grid(size, size, [&](i64 x, i64 y) {
+        return !empty_rows[y] && !empty_cols[x] && chance(rng, 0.02) ? '#' : '.';
+    });
+};
+
+// Each row is made from a real arrangement of its groups, so there's always at
+// least one solution. The unfolding factor of 5 is fixed by the puzzle, so
+// only the number of rows scales.
+auto gen_dec12 = [](rng_t& rng, i64 scale) -> std::string
+{
+    std::string out;
+    auto it = std::back_inserter(out);
+    for (auto _ : flux::ints(0, 1000 * scale)) {
+        std::vector<i64> groups(uniform(rng, 1, 5));
+        std::string record(uniform(rng, 0, 2), '.');
+        for (auto i : flux::ints(0, flux::size(groups))) {
+            groups[i] = uniform(rng, 1, 3);
+            record.append(groups[i], '#');
+            record.append(i + 1 < flux::size(groups) ? uniform(rng, 1, 2) : uniform(rng, 0, 2), '.');
+        }
+        for (char& c : record) {
+            if (chance(rng, 0.5)) {
+                c = '?';
+            }
+        }
+        fmt::format_to(it, "{} {}\n", record, fmt::join(groups, ","));
+    }
+    return out;
+};
+
+// Each pattern is symmetric about one horizontal line, and about one vertical
+// line apart from a single smudge (outside the horizontal reflection, so as
+// not to spoil it)
+auto gen_dec13 = [](rng_t& rng, i64 scale) -> std::string
+{
+    std::vector<std::string> patterns;
+    for (auto _ : flux::ints(0, 100 * scale)) {
+        auto const width = uniform(rng, 7, 17);
+        auto const height = uniform(rng, 7, 17);
+        auto const col = uniform(rng, 1, width - 1);
+        i64 row = 0;
+        do {
+            row = uniform(rng, 1, height - 1);
+        } while (2 * row == height);
+
+        std::vector<std::string> grid(height, std::string(width, '.'));
+        for (auto& line : grid) {
+            for (char& c : line) {
+                c = pick(rng, ".#");
+            }
+            for (auto x : flux::ints(std::max<i64>(0, 2 * col - width), col)) {
+                line[2 * col - 1 - x] = line[x];
+            }
+        }
+        for (auto y : flux::ints(std::max<i64>(0, 2 * row - height), row)) {
+            grid[2 * row - 1 - y] = grid[y];
+        }
+
+        auto const smudge_y = 2 * row < height ? uniform(rng, 2 * row, height - 1)
+                                               : uniform(rng, 0, 2 * row - height - 1);
+        auto const smudge_x = uniform(rng, std::max<i64>(0, 2 * col - width),
+                                      std::min<i64>(width, 2 * col) - 1);
+        char& c = grid[smudge_y][smudge_x];
+        c = c == '#' ? '.' : '#';
+
+        patterns.push_back(fmt::format("{}\n", fmt::join(grid, "\n")));
+    }
+    return fmt::format("{}", fmt::join(patterns, "\n"));
+};
+
+auto gen_dec14 = [](rng_t& rng, i64 scale) -> std::string
+{
+    i64 const size = 100 * scale;
+    return make_grid(size, size, [&](i64, i64) {
+        return chance(rng, 0.2) ? 'O' : chance(rng, 0.2) ? '#' : '.';
+    });
+};
+
+// The solution splits the whole input on commas, so there's no final newline
+auto gen_dec15 = [](rng_t& rng, i64 scale) -> std::string
+{
+    std::vector<std::string> labels(500);
+    for (auto& label : labels) {
+        for (auto _ : flux::ints(0, uniform(rng, 2, 6))) {
+            label.push_back(pick(rng, "abcdefghijklmnopqrstuvwxyz"));
+        }
+    }
+
+    std::vector<std::string> steps;
+    for (auto _ : flux::ints(0, 4000 * scale)) {
+        auto const& label = labels[uniform(rng, 0, flux::size(labels) - 1)];
+        steps.push_back(chance(rng, 0.4) ? label + '-'
+                                         : fmt::format("{}={}", label, uniform(rng, 1, 9)));
+    }
+    return fmt::format("{}", fmt::join(steps, ","));
+};
+
+auto gen_dec16 = [](rng_t& rng, i64 scale) -> std::string
+{
+    i64 const size = 110 * scale;
+    return make_grid(size, size, [&](i64, i64) {
+        return chance(rng, 0.1) ? pick(rng, "/\\|-") : '.';
+    });
+};
+
+auto gen_dec17 = [](rng_t& rng, i64 scale) -> std::string
+{
+    i64 const size = 141 * scale;
+    return make_grid(size, size, [&](i64, i64) { return pick(rng, "123456789"); });
+};
+
+// Both parts dig around the same simple polygon, stretched by different
+// amounts, so that neither crosses itself
+auto gen_dec18 = [](rng_t& rng, i64 scale) -> std::string
+{
+    i64 const n = 50 * scale;
+    auto const loop = outline(grow_region(rng, n, 0.5));
+
+    // Map the region's grid lines to increasing coordinates. Part 2's distances
+    // must fit in five hex digits.
+    auto stretch = [&](i64 max_gap) {
+        std::vector<i64> coords{0};
+        for (auto _ : flux::ints(0, n)) {
+            coords.push_back(coords.back() + uniform(rng, 1, max_gap));
+        }
+        return coords;
+    };
+    auto const xs1 = stretch(8), ys1 = stretch(8);
+    auto const xs2 = stretch(0xfffff / n), ys2 = stretch(0xfffff / n);
+
+    // Merge the steps around the outline into straight runs
+    std::string out;
+    auto it = std::back_inserter(out);
+    auto const len = flux::size(loop);
+    i64 i = 0;
+    while (i < len) {
+        auto const [x0, y0] = loop[i];
+        auto const [dx, dy] = std::pair(loop[(i + 1) % len].first - x0,
+                                        loop[(i + 1) % len].second - y0);
+        auto j = i + 1;
+        while (j < len && loop[(j + 1) % len].first - loop[j].first == dx &&
+               loop[(j + 1) % len].second - loop[j].second == dy) {
+            ++j;
+        }
+        auto const [x1, y1] = loop[j % len];
+
+        auto const dist1 = std::abs(xs1[x1] - xs1[x0]) + std::abs(ys1[y1] - ys1[y0]);
+        auto const dist2 = std::abs(xs2[x1] - xs2[x0]) + std::abs(ys2[y1] - ys2[y0]);
+        auto const [dir, code] = dx > 0 ? std::pair('R', 0)
+                               : dy > 0 ? std::pair('D', 1)
+                               : dx < 0 ? std::pair('L', 2)
+                                        : std::pair('U', 3);
+
+        fmt::format_to(it, "{} {} (#{:05x}{})\n", dir, dist1, dist2, code);
+        i = j;
+    }
+    return out;
+};
+
+// The workflows form a tree rooted at "in", so every part ends up at A or R
+auto gen_dec19 = [](rng_t& rng, i64 scale) -> std::string
+{
+    i64 const n_workflows = 550 * scale;
+
+    std::set<std::string> used{"in"};
+    auto new_name = [&] {
+        while (true) {
+            std::string name;
+            for (auto _ : flux::ints(0, uniform(rng, 2, 3))) {
+                name.push_back(pick(rng, "abcdefghijklmnopqrstuvwxyz"));
+            }
+            if (used.insert(name).second) {
+                return name;
+            }
+        }
+    };
+
+    std::vector<std::string> names{"in"};
+    std::vector<std::string> lines;
+    auto dest = [&] {
+        if (i64(names.size()) < n_workflows && chance(rng, 0.6)) {
+            names.push_back(new_name());
+            return names.back();
+        }
+        return std::string(1, pick(rng, "AR"));
+    };
+
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        std::string line = names[i] + '{';
+        for (auto _ : flux::ints(0, uniform(rng, 1, 4))) {
+            line += fmt::format("{}{}{}:{},", pick(rng, "xmas"), pick(rng, "<>"),
+                                uniform(rng, 1, 4000), dest());
+        }
+        lines.push_back(line + dest() + '}');
+    }
+    shuffle(rng, lines);
+
+    std::string out = fmt::format("{}\n\n", fmt::join(lines, "\n"));
+    auto it = std::back_inserter(out);
+    for (auto _ : flux::ints(0, 200 * scale)) {
+        fmt::format_to(it, "{{x={},m={},a={},s={}}}\n",
+                       uniform(rng, 1, 4000), uniform(rng, 1, 4000),
+                       uniform(rng, 1, 4000), uniform(rng, 1, 4000));
+    }
+    return out;
+};
+
+// Part 2 depends on the exact structure of the real inputs: four 12-bit
+// counters made of flip-flops, each reset by a conjunction when it reaches a
+// prime, feeding inverters which must be called nd, pc, vd and tx. So this
+// one can't usefully be scaled either.
+auto gen_dec20 = [](rng_t& rng, i64) -> std::string
+{
+    std::set<std::string> used{"nd", "pc", "vd", "tx", "rx"};
+    auto new_name = [&] {
+        while (true) {
+            std::string name{pick(rng, "abcdefghijklmnopqrstuvwxyz"),
+                             pick(rng, "abcdefghijklmnopqrstuvwxyz")};
+            if (used.insert(name).second) {
+                return name;
+            }
+        }
+    };
+
+    auto const final_conj = new_name();
+    std::vector<std::string> lines{fmt::format("&{} -> rx", final_conj)};
+    std::vector<std::string> firsts;
+    std::vector<i64> periods;
+
+    for (std::string inverter : {"nd", "pc", "vd", "tx"}) {
+        auto const period = random_prime(rng, 3700, 4095, periods);
+        auto const hub = new_name();
+        std::vector<std::string> flops;
+        for (auto _ : flux::ints(0, 12)) {
+            flops.push_back(new_name());
+        }
+        firsts.push_back(flops[0]);
+
+        std::vector<std::string> hub_dests{flops[0]};
+        for (auto bit : flux::ints(0, 12)) {
+            std::vector<std::string> dests;
+            if (bit < 11) {
+                dests.push_back(flops[bit + 1]);
+            }
+            if (period & (1 << bit)) {
+                dests.push_back(hub);
+            } else {
+                hub_dests.push_back(flops[bit]);
+            }
+            shuffle(rng, dests);
+            lines.push_back(fmt::format("%{} -> {}", flops[bit], fmt::join(dests, ", ")));
+        }
+        hub_dests.push_back(inverter);
+        shuffle(rng, hub_dests);
+
+        lines.push_back(fmt::format("&{} -> {}", hub, fmt::join(hub_dests, ", ")));
+        lines.push_back(fmt::format("&{} -> {}", inverter, final_conj));
+    }
+
+    shuffle(rng, firsts);
+    lines.push_back(fmt::format("broadcaster -> {}", fmt::join(firsts, ", ")));
+    shuffle(rng, lines);
+
+    return fmt::format("{}\n", fmt::join(lines, "\n"));
+};
+
+// A square grid with an odd side and S in the centre, with clear paths along
+// the middle row and column and around the edges. Part 2's extrapolation
+// assumes a side of exactly 131, so only scale 1 gives a meaningful answer.
+auto gen_dec21 = [](rng_t& rng, i64 scale) -> std::string
+{
+    i64 const size = 131 * scale + (scale % 2 == 0);
+    i64 const mid = size / 2;
+    return make_grid(size, size, [&](i64 x, i64 y) {
+        if (x == mid && y == mid) {
+            return 'S';
+        }
+        bool const clear = x == mid || y == mid || x == 0 || y == 0 ||
+                           x == size - 1 || y == size - 1;
+        return !clear && chance(rng, 0.15) ? '#' : '.';
+    });
+};
+
+// Bricks are dropped one at a time onto a 10x10 floor, with random gaps
+// underneath, so that none of them overlap
+auto gen_dec22 = [](rng_t& rng, i64 scale) -> std::string
+{
+    constexpr i64 floor_size = 10;
+    std::array<std::array<i64, floor_size>, floor_size> heights{};
+
+    std::vector<std::string> lines;
+    for (auto _ : flux::ints(0, 1250 * scale)) {
+        auto const axis = uniform(rng, 0, 2);
+        auto const len = uniform(rng, 0, 4);
+        std::array<i64, 3> from{uniform(rng, 0, floor_size - 1), uniform(rng, 0, floor_size - 1), 0};
+        std::array<i64, 3> to = from;
+        if (axis < 2) {
+            from[axis] = std::min(from[axis], floor_size - 1 - len);
+            to[axis] = from[axis] + len;
+        }
+
+        i64 top = 0;
+        for (auto x : flux::ints(from[0], to[0] + 1)) {
+            for (auto y : flux::ints(from[1], to[1] + 1)) {
+                top = std::max(top, heights[x][y]);
+            }
+        }
+        from[2] = top + 1 + uniform(rng, 0, 3);
+        to[2] = from[2] + (axis == 2 ? len : 0);
+
+        for (auto x : flux::ints(from[0], to[0] + 1)) {
+            for (auto y : flux::ints(from[1], to[1] + 1)) {
+                heights[x][y] = to[2];
+            }
+        }
+        lines.push_back(fmt::format("{}~{}", fmt::join(from, ","), fmt::join(to, ",")));
+    }
+    shuffle(rng, lines);
+
+    return fmt::format("{}\n", fmt::join(lines, "\n"));
+};
+
+// Every hailstone is hit by a single rock thrown at integer times, as part 2
+// requires
+auto gen_dec24 = [](rng_t& rng, i64 scale) -> std::string
+{
+    std::array<i64, 3> const rock_pos{uniform(rng, 150'000'000'000'000, 350'000'000'000'000),
+                                      uniform(rng, 150'000'000'000'000, 350'000'000'000'000),
+                                      uniform(rng, 150'000'000'000'000, 350'000'000'000'000)};
+    std::array<i64, 3> const rock_vel{uniform(rng, -250, 250), uniform(rng, -250, 250),
+                                      uniform(rng, -250, 250)};
+
+    std::string out;
+    auto it = std::back_inserter(out);
+    for (auto _ : flux::ints(0, 300 * scale)) {
+        auto const t = uniform(rng, 10'000'000'000, 300'000'000'000);
+        std::array<i64, 3> vel{};
+        std::array<i64, 3> pos{};
+        for (auto i : flux::ints(0, 3)) {
+            do {
+                vel[i] = uniform(rng, -300, 300);
+            } while (vel[i] == 0); // part 1 divides by the x velocity
+            pos[i] = rock_pos[i] + t * (rock_vel[i] - vel[i]);
+        }
+        fmt::format_to(it, "{} @ {}\n", fmt::join(pos, ", "), fmt::join(vel, ", "));
+    }
+    return out;
+};
+
+struct generator {
+    std::string_view name;
+    std::string (*fn)(rng_t&, i64);
+};
+
+constexpr auto generators = std::array<generator, 23>{{
+    {"dec01", gen_dec01}, {"dec02", gen_dec02}, {"dec03", gen_dec03},
+    {"dec04", gen_dec04}, {"dec05", gen_dec05}, {"dec06", gen_dec06},
+    {"dec07", gen_dec07}, {"dec08", gen_dec08}, {"dec09", gen_dec09},
+    {"dec10", gen_dec10}, {"dec11", gen_dec11}, {"dec12", gen_dec12},
+    {"dec13", gen_dec13}, {"dec14", gen_dec14}, {"dec15", gen_dec15},
+    {"dec16", gen_dec16}, {"dec17", gen_dec17}, {"dec18", gen_dec18},
+    {"dec19", gen_dec19}, {"dec20", gen_dec20}, {"dec21", gen_dec21},
+    {"dec22", gen_dec22}, {"dec24", gen_dec24}
+}};
+
+struct options {
+    fs::path output_dir;
+    std::uint64_t seed = 2023;
+    i64 scale = 1;
+    std::vector<std::string> days; // empty means all of them
+};
+
+auto parse_args = [](int argc, char** argv) -> std::optional<options>
+{
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&] -> std::string_view {
+            return ++i < argc ? argv[i] : "";
+        };
+
+        if (arg == "--seed") {
+            auto seed = aoc::try_parse<std::uint64_t>(next());
+            if (!seed) {
+                return std::nullopt;
+            }
+            opts.seed = *seed;
+        } else if (arg == "--scale") {
+            opts.scale = aoc::try_parse<i64>(next()).value_or(0);
+        } else if (arg == "--day") {
+            opts.days.emplace_back(next());
+        } else {
+            opts.output_dir = arg;
+        }
+    }
+
+    if (opts.output_dir.empty() || opts.scale < 1) {
+        return std::nullopt;
+    }
+    return opts;
+};
+
+}
+
+int main(int argc, char** argv)
+{
+    auto const maybe_opts = parse_args(argc, argv);
+    if (!maybe_opts) {
+        fmt::println(stderr, "Usage: aoc_gen [--seed N] [--scale N] [--day decNN]... <output-dir>");
+        return -1;
+    }
+    auto const& opts = *maybe_opts;
+
+    fs::create_directories(opts.output_dir);
+
+    for (auto const& [name, fn] : generators) {
+        if (!opts.days.empty() && !flux::contains(opts.days, name)) {
+            continue;
+        }
+
+        // Seed each day separately, so that generating a subset of the days
+        // gives the same files as generating all of them
+        std::seed_seq seq{std::uint32_t(opts.seed), std::uint32_t(opts.seed >> 32),
+                          std::uint32_t(aoc::parse<int>(name.substr(3)))};
+        rng_t rng(seq);
+
+        auto const path = opts.output_dir / fmt::format("{}.txt", name);
+        auto const contents = fn(rng, opts.scale);
+        std::ofstream(path, std::ios::binary) << contents;
+        fmt::println("Wrote {} ({} bytes)", path.string(), contents.size());
+    }
+}
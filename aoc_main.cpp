@@ -0,0 +1,14 @@
+// The main() for each day's executable, which runs the function registered
+// with aoc::register_main() by the one day linked in
+
+#include "aoc.hpp"
+
+int main(int argc, char** argv)
+{
+    auto const& mains = aoc::registered_mains();
+    if (mains.size() != 1) {
+        fmt::println(stderr, "Expected one day to be linked in, but found {}", mains.size());
+        return -1;
+    }
+    return mains.front()(argc, argv);
+}
@@ -0,0 +1,22 @@
+# Compares aoc_bench timings against a saved baseline, for the bench_check
+# targets, and fails if any phase got slower. If no baseline has been saved
+# yet there's nothing to compare against, so the check is skipped instead.
+#
+# Usage: cmake -DAOC_BENCH=<exe> -DBASELINE=<file> -DINPUTS=<dir> -DREPS=<n>
+#              [-DDAY=decNN] -P bench_check.cmake
+
+if(NOT EXISTS ${BASELINE})
+    message(STATUS "No benchmark baseline at ${BASELINE}, skipping the check "
+                   "(build bench_baseline to save one)")
+    return()
+endif()
+
+set(ARGS --reps ${REPS} --compare ${BASELINE})
+if(DAY)
+    list(APPEND ARGS --day ${DAY})
+endif()
+
+execute_process(COMMAND ${AOC_BENCH} ${ARGS} ${INPUTS} RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "Benchmark check failed")
+endif()
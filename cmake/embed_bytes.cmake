@@ -0,0 +1,11 @@
+# Writes the bytes of the file INPUT to OUTPUT as a comma-separated list of
+# character literals, for #including into a char array initialiser. This is
+# what C++26's #embed does, for compilers which don't support it yet. Integer
+# literals of 0x80 and above would be narrowing conversions where char is
+# signed, but '\xNN' is always a char.
+#
+# Usage: cmake -DINPUT=<file> -DOUTPUT=<file> -P embed_bytes.cmake
+
+file(READ ${INPUT} hex HEX)
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "'\\\\x\\1'," bytes "${hex}")
+file(WRITE ${OUTPUT} "${bytes}\n")
@@ -20,7 +20,7 @@ auto find_digits_part1 = [](std::string_view const line) -> int {
 };
 
 auto part1 = [](std::string_view const input) -> int {
-    return flux::split_string(input, '\n')
+    return aoc::line_index(input).lines()
         .filter([](std::string_view const line) { return !line.empty(); })
         .map(find_digits_part1)
         .sum();
@@ -76,13 +76,37 @@ auto find_last_digit = [](std::string_view line) -> int {
 };
 
 auto part2 = [](std::string_view const input) -> int {
-    return flux::split_string(input, '\n')
+    return aoc::line_index(input).lines()
         .map([](std::string_view const line) -> int {
             return 10 * find_first_digit(line) + find_last_digit(line);
         })
         .sum();
 };
 
+/*
+ * Streaming
+ */
+
+// Both parts in a single pass over the lines, so that input piped to stdin
+// never has to be held in memory
+constexpr auto streaming = aoc::streaming_solution{
+    .delimiter = '\n',
+    .part1 = aoc::record_fold{
+        .init = 0,
+        .step = [](int& sum, std::string_view const line) {
+            if (!line.empty()) {
+                sum += find_digits_part1(line);
+            }
+        }
+    },
+    .part2 = aoc::record_fold{
+        .init = 0,
+        .step = [](int& sum, std::string_view const line) {
+            sum += 10 * find_first_digit(line) + find_last_digit(line);
+        }
+    }
+};
+
 /*
  * Tests
  */
@@ -94,6 +118,7 @@ a1b2c3d4e5f
 treb7uchet)";
 
 static_assert(part1(test_data_p1) == 142);
+static_assert(aoc::fold_records(streaming.part1, '\n', test_data_p1) == 142);
 
 constexpr auto& test_data_p2 =
 R"(two1nine
@@ -105,18 +130,21 @@ zoneight234
 7pqrstsixteen)";
 
 static_assert(part2(test_data_p2) == 281);
+static_assert(aoc::fold_records(streaming.part2, '\n', test_data_p2) == 281);
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = aoc::raw_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec01", solution);
+
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec01", solution, argc, argv, streaming);
+}
 
-    auto const input = aoc::string_from_file(argv[1]);
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
 }
@@ -56,17 +56,16 @@ auto parse_line = [](std::string_view line) -> game
 
 auto parse_input = [](std::string_view input) -> std::vector<game>
 {
-    return flux::split_string(input, '\n')
-                .filter([](std::string_view line) { return !line.empty(); })
-                .map(parse_line)
-                .to<std::vector>();
+    return aoc::parse_lines(input, parse_line);
 };
 
-auto part1 = [](flux::sequence auto const& games) -> int {
-    auto possible = [](game const& g) {
-        return g.red <= 12 && g.green <= 13 && g.blue <= 14;
-    };
+auto possible = [](game const& g) {
+    return g.red <= 12 && g.green <= 13 && g.blue <= 14;
+};
+
+auto power = [](game const& g) { return g.red * g.green * g.blue; };
 
+auto part1 = [](flux::sequence auto const& games) -> int {
     return flux::ref(games)
             .filter(possible)
             .map(&game::id)
@@ -74,10 +73,35 @@ auto part1 = [](flux::sequence auto const& games) -> int {
 };
 
 auto part2 = [](flux::sequence auto const& games) -> int {
-    auto power = [](game const& g) { return g.red * g.green * g.blue; };
     return flux::ref(games).map(power).sum();
 };
 
+// Both parts in a single pass over the lines, so that input piped to stdin
+// never has to be held in memory
+constexpr auto streaming = aoc::streaming_solution{
+    .delimiter = '\n',
+    .part1 = aoc::record_fold{
+        .init = 0,
+        .step = [](int& sum, std::string_view line) {
+            if (line.empty()) {
+                return;
+            }
+            game const g = parse_line(line);
+            if (possible(g)) {
+                sum += g.id;
+            }
+        }
+    },
+    .part2 = aoc::record_fold{
+        .init = 0,
+        .step = [](int& sum, std::string_view line) {
+            if (!line.empty()) {
+                sum += power(parse_line(line));
+            }
+        }
+    }
+};
+
 constexpr auto& test_data =
 R"(Game 1: 3 blue, 4 red; 1 red, 2 green, 6 blue; 2 green
 Game 2: 1 blue, 2 green; 3 green, 4 blue, 1 red; 1 green, 1 blue
@@ -93,18 +117,22 @@ auto test = [] -> bool {
     return p1 == 8 && p2 == 2286;
 };
 static_assert(test());
+static_assert(aoc::fold_records(streaming.part1, '\n', test_data) == 8);
+static_assert(aoc::fold_records(streaming.part2, '\n', test_data) == 2286);
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec02", solution);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec02", solution, argc, argv, streaming);
+}
 
-    auto const games = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(games));
-    fmt::println("Part 2: {}", part2(games));
-}
\ No newline at end of file
+}
@@ -3,6 +3,8 @@
 
 #include <charconv>
 
+namespace {
+
 struct grid_t {
     struct position {
         int x;
@@ -117,22 +119,25 @@ R"(467..114..
 .664.598..
 )";
 
-int main(int argc, char** argv)
-{
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec03", solution);
 
+auto day_main(int argc, char** argv) -> int
+{
     {
         auto const test_grid = parse_input(test_data);
         assert(part1(test_grid) == 4361);
         assert(part2(test_grid) == 467835);
     }
 
-    auto grid = parse_input(aoc::string_from_file(argv[1]));
-
-    fmt::println("Part 1: {}", part1(grid));
-    fmt::println("Part 2: {}", part2(grid));
+    return aoc::run("dec03", solution, argc, argv);
 }
 
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
+
+}
@@ -21,18 +21,15 @@ auto read_nums = [](std::string_view line) -> std::vector<int>
 
 auto parse_input = [](std::string_view input)
 {
-    return flux::split_string(input, '\n')
-                .filter([](std::string_view line) { return !line.empty(); })
-                .map([](std::string_view line) -> card_t {
-                    auto colon = line.find(':');
-                    auto bar = line.find('|', colon + 1);
-
-                    return card_t{
-                        .winning = read_nums(line.substr(colon + 1, bar - colon - 1)),
-                        .have = read_nums(line.substr(bar+1))
-                    };
-                })
-                .to<std::vector>();
+    return aoc::parse_lines(input, [](std::string_view line) -> card_t {
+        auto colon = line.find(':');
+        auto bar = line.find('|', colon + 1);
+
+        return card_t{
+            .winning = read_nums(line.substr(colon + 1, bar - colon - 1)),
+            .have = read_nums(line.substr(bar+1))
+        };
+    });
 };
 
 auto matching_numbers = [](card_t const& card) -> auto {
@@ -80,17 +77,19 @@ static_assert([] {
            part2(test_cards) == 30;
 }());
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec04", solution);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec04", solution, argc, argv);
+}
 
-    auto const cards = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(cards));
-    fmt::println("Part 2: {}", part2(cards));
-}
\ No newline at end of file
+}
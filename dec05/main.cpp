@@ -1,6 +1,8 @@
 
 #include "../aoc.hpp"
 
+#include <limits>
+
 namespace {
 
 using i64 = std::int64_t;
@@ -57,21 +59,24 @@ auto parse_input = [](std::string_view input) -> std::pair<std::vector<i64>, map
     return std::pair(std::move(seeds), std::move(maps));
 };
 
+auto seed_to_location = [](maps_t const& maps, i64 seed) -> i64
+{
+    for (mapping const& map : maps) {
+        for (map_entry const& e : map) {
+            i64 offset = seed - e.source_start;
+            if (offset >= 0 && offset < e.length) {
+                seed = e.dest_start + offset;
+                break;
+            }
+        }
+    }
+    return seed;
+};
+
 auto part1 = [](std::vector<i64> const& seeds, maps_t const& maps) -> i64
 {
     return flux::ref(seeds)
-            .map([&maps](i64 seed) -> i64 {
-                 for (mapping const& map : maps) {
-                     for (map_entry const& e : map) {
-                         i64 offset = seed - e.source_start;
-                         if (offset >= 0 && offset < e.length) {
-                             seed = e.dest_start + offset;
-                             break;
-                         }
-                     }
-                 }
-                 return seed;
-             })
+            .map([&maps](i64 seed) { return seed_to_location(maps, seed); })
             .min()
             .value();
 };
@@ -83,57 +88,31 @@ struct seed_range {
 
 auto part2 = [](std::vector<i64> const& seeds, maps_t const& maps) -> i64
 {
-    auto ranges = flux::ref(seeds)
-                      .pairwise()
-                      .stride(2)
-                      .map(flux::unpack([](i64 a, i64 b) { return seed_range{a, b}; }))
-                      .to<std::vector>();
-#ifdef USE_OPENMP
-    std::vector<i64> mins(ranges.size());
-
-#pragma omp parallel for
-    for (size_t i = 0; i < mins.size(); ++i) {
-        seed_range r = ranges.at(i);
-        mins.at(i) = flux::iota(r.start, r.start + r.length)
-            .map([&maps](i64 seed) -> i64 {
-                for (mapping const& map : maps) {
-                    for (map_entry const& e : map) {
-                        i64 offset = seed - e.source_start;
-                        if (offset >= 0 && offset < e.length) {
-                            seed = e.dest_start + offset;
-                            break;
-                        }
-                    }
-                }
-                return seed;
-            })
-            .min().value();
-    }
-    return flux::min(mins).value();
-#else
-    return flux::ref(ranges)
-            .map([&maps](seed_range r) {
-                return flux::iota(r.start, r.start + r.length)
-                        .map([&maps](i64 seed) -> i64 {
-                            for (mapping const& map : maps) {
-                                for (map_entry const& e : map) {
-                                    i64 offset = seed - e.source_start;
-                                    if (offset >= 0 && offset < e.length) {
-                                        seed = e.dest_start + offset;
-                                        break;
-                                    }
-                                }
-                            }
-                            return seed;
-                        })
-                        .min().value();
-             })
-            .min()
-            .value();
-#endif
+    // The seed ranges have very different lengths, so chop them up into
+    // smaller chunks to let the thread pool balance the load
+    constexpr i64 chunk_size = 1 << 20;
+
+    std::vector<seed_range> chunks;
+    flux::ref(seeds)
+        .pairwise()
+        .stride(2)
+        .for_each(flux::unpack([&chunks](i64 start, i64 length) {
+            for (i64 from = start; from < start + length; from += chunk_size) {
+                chunks.push_back({from, std::min(chunk_size, start + length - from)});
+            }
+        }));
+
+    return aoc::parallel_reduce(0, flux::size(chunks), std::numeric_limits<i64>::max(),
+        [&](i64 idx) {
+            seed_range r = chunks.at(idx);
+            return flux::iota(r.start, r.start + r.length)
+                    .map([&maps](i64 seed) { return seed_to_location(maps, seed); })
+                    .min()
+                    .value();
+        },
+        [](i64 a, i64 b) { return std::min(a, b); });
 };
 
-
 constexpr auto& test_data =
 R"(seeds: 79 14 55 13
 
@@ -169,26 +148,25 @@ humidity-to-location map:
 60 56 37
 56 93 4)";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = flux::unpack(part1),
+    .part2 = flux::unpack(part2)
+};
 
-int main(int argc, char** argv)
-{
-    {
-        if (argc < 2) {
-            fmt::println(stderr, "No input");
-            return -1;
-        }
-    }
+[[maybe_unused]] bool const registered = aoc::register_day("dec05", solution, 5);
 
+auto day_main(int argc, char** argv) -> int
+{
     {
         auto const [seeds, maps] = parse_input(test_data);
         assert(part1(seeds, maps) == 35);
         assert(part2(seeds, maps) == 46);
     }
 
-    auto const [seeds, maps] = parse_input(aoc::string_from_file(argv[1]));
+    return aoc::run("dec05", solution, argc, argv);
+}
 
-    fmt::println("Part 1: {}", part1(seeds, maps));
-    fmt::println("Part 2: {}", part2(seeds, maps));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-}
\ No newline at end of file
+}
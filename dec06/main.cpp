@@ -7,12 +7,41 @@ using i64 = std::int64_t;
 
 auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
 
+// Newton's method, rounding down
+auto isqrt = [](i64 n) -> i64
+{
+    if (n < 2) {
+        return n;
+    }
+    i64 x = n;
+    i64 y = (x + 1) / 2;
+    while (y < x) {
+        x = y;
+        y = (x + n / x) / 2;
+    }
+    return x;
+};
+
+// We win if hold * (time - hold) > dist. The integer square root gets us to
+// within a step of the smaller root, so we just nudge min onto the first win;
+// by symmetry, the last win is at time - min. Sticking to integers means this
+// works at compile time with any standard library, not just libstdc++.
 auto calculate = [](i64 time, i64 dist) -> i64
 {
-    double disc = std::sqrt(time * time - 4 * dist);
-    i64 min = std::floor((time - disc)/2 + 1.0);
-    i64 max = std::ceil((time + disc)/2 - 1.0);
-    return max - min + 1;
+    auto wins = [&](i64 hold) { return hold * (time - hold) > dist; };
+
+    i64 const disc = time * time - 4 * dist;
+    if (disc <= 0) {
+        return 0;
+    }
+    i64 min = (time - isqrt(disc)) / 2;
+    while (min > 0 && wins(min - 1)) {
+        --min;
+    }
+    while (min <= time / 2 && !wins(min)) {
+        ++min;
+    }
+    return min <= time / 2 ? time - 2 * min + 1 : 0;
 };
 
 auto part1 = [](std::string_view input) -> i64
@@ -48,25 +77,22 @@ constexpr auto& test_data =
 R"(Time:      7  15   30
 Distance:  9  40  200)";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = aoc::raw_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec06", solution);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
-    // With libstdc++, we can test at compile time
-#ifdef __GLIBCXX__
     static_assert(part1(test_data) == 288);
     static_assert(part2(test_data) == 71503);
-#else
-    assert(part1(test_data) == 288);
-    assert(part2(test_data) == 71503);
-#endif
-
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
 
-    auto const input = aoc::string_from_file(argv[1]);
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
+    return aoc::run("dec06", solution, argc, argv);
+}
+
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
+
 }
@@ -14,7 +14,7 @@ enum class hand_kind {
 
 auto parse_input = [](std::string_view input) -> std::vector<std::pair<hand_t, int>>
 {
-    return flux::split_string(input, '\n')
+    return aoc::line_index(input).lines()
             .filter([](auto line) { return !line.empty(); })
             .map([](std::string_view line) {
                 return std::pair(std::string(line.substr(0, 5)), aoc::parse<int>(line.substr(6)));
@@ -137,17 +137,19 @@ static_assert([]{
         && part2(pairs) == 5905;
 }());
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec07", solution);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec07", solution, argc, argv);
+}
 
-    auto const hands_and_bids = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(hands_and_bids));
-    fmt::println("Part 2: {}", part2(hands_and_bids));
-}
\ No newline at end of file
+}
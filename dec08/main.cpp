@@ -3,65 +3,74 @@
 
 #include <numeric>
 
-#include <ankerl/unordered_dense.h>
-
 namespace {
 
 using i64 = std::int64_t;
 
+using id_type = aoc::interner::id_type;
+
+// Nodes are numbered as they are parsed, so the network is just an array
 struct node {
-    std::string left;
-    std::string right;
+    std::array<id_type, 2> next; // left, right
+    bool is_start; // name ends with A
+    bool is_end; // name ends with Z
 };
 
-using node_map = ankerl::unordered_dense::map<std::string, node>;
+struct network {
+    std::vector<std::uint8_t> instructions; // 0 for left, 1 for right
+    std::vector<node> nodes;
+    aoc::interner names;
+};
 
-auto parse_input = [](std::string_view input) -> std::pair<std::string, node_map>
+auto parse_input = [](std::string_view input) -> network
 {
     auto nl = input.find("\n\n");
 
-    auto instructions = std::string(input.substr(0, nl));
-
-    auto map = flux::split_string(input.substr(nl + 2), '\n')
-                .filter([](auto line) { return !line.empty(); })
-                .map([](std::string_view line) {
-                       return std::pair(std::string(line.substr(0, 3)),
-                                        node{std::string(line.substr(7, 3)),
-                                             std::string(line.substr(12, 3))});
-                })
-                .to<node_map>();
-
-    return std::pair(std::move(instructions), std::move(map));
+    network net;
+    net.instructions = flux::map(input.substr(0, nl), [](char c) -> std::uint8_t {
+                           return c == 'R';
+                       }).to<std::vector>();
+
+    flux::split_string(input.substr(nl + 2), '\n')
+        .filter([](auto line) { return !line.empty(); })
+        .for_each([&net](std::string_view line) {
+            auto const id = net.names.intern(line.substr(0, 3));
+            auto const left = net.names.intern(line.substr(7, 3));
+            auto const right = net.names.intern(line.substr(12, 3));
+            net.nodes.resize(net.names.size());
+            net.nodes[id] = node{.next = {left, right},
+                                 .is_start = line[2] == 'A',
+                                 .is_end = line[2] == 'Z'};
+        });
+
+    return net;
 };
 
-auto find_path_length = [](std::string where,
-                           std::string_view instructions,
-                           node_map const& nodes) -> i64
+auto find_path_length = [](id_type where, network const& net) -> i64
 {
     i64 counter = 0;
-    for (char inst : flux::cycle(instructions)) {
-        if (where.back() == 'Z') {
+    for (std::uint8_t inst : flux::cycle(flux::ref(net.instructions))) {
+        node const& n = net.nodes[where];
+        if (n.is_end) {
             break;
         }
         ++counter;
-        node const& n = nodes.at(where);
-        where = (inst == 'L') ? n.left : n.right;
+        where = n.next[inst];
     }
     return counter;
 };
 
-auto part1 = [](std::string_view instructions, node_map const& nodes) -> i64
+auto part1 = [](network const& net) -> i64
 {
-    return find_path_length("AAA", instructions, nodes);
+    return find_path_length(net.names.find("AAA").value(), net);
 };
 
-auto part2 = [](std::string_view instructions, node_map const& nodes) -> i64
+auto part2 = [](network const& net) -> i64
 {
-    return  flux::from_crange(nodes)
-                .map(&node_map::value_type::first)
-                .filter([](std::string_view s) { return s.back() == 'A'; })
-                .map([&](std::string const& from) {
-                    return find_path_length(from, instructions, nodes);
+    return flux::ints(0, flux::size(net.nodes))
+                .filter([&](auto id) { return net.nodes[id].is_start; })
+                .map([&](auto id) {
+                    return find_path_length(static_cast<id_type>(id), net);
                 })
                 .fold([](i64 a, i64 b) { return std::lcm(a, b); }, 1);
 };
@@ -96,33 +105,24 @@ R"(LR
 22Z = (22B, 22B)
 XXX = (XXX, XXX))";
 
-}
-
-int main(int argc, char** argv)
-{
-    // Alas, no constexpr tests today because of std::unordered_map
-    {
-        auto const [instr, map] = parse_input(test_data1);
-        assert(part1(instr, map) == 2);
-    }
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-    {
-        auto const [instr, map] = parse_input(test_data2);
-        assert(part1(instr, map) == 6);
-    }
+[[maybe_unused]] bool const registered = aoc::register_day("dec08", solution);
 
-    {
-        auto const [instr, map] = parse_input(test_data3);
-        assert(part2(instr, map) == 6);
-    }
+auto day_main(int argc, char** argv) -> int
+{
+    // Alas, no constexpr tests today because of the interner's hash map
+    assert(part1(parse_input(test_data1)) == 2);
+    assert(part1(parse_input(test_data2)) == 6);
+    assert(part2(parse_input(test_data3)) == 6);
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec08", solution, argc, argv);
+}
 
-    auto const [instructions, nodes] = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(instructions, nodes));
-    fmt::println("Part 2: {}", part2(instructions, nodes));
-}
\ No newline at end of file
+}
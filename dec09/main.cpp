@@ -5,12 +5,11 @@ namespace {
 
 auto parse_input = [](std::string_view input) -> std::vector<std::vector<int>>
 {
-    return flux::split_string(input, '\n')
-              .filter([](auto line) { return !line.empty(); })
-              .map([](std::string_view line) -> std::vector<int> {
-                  return flux::split_string(line, ' ').map(aoc::parse<int>).to<std::vector>();
-              })
-              .to<std::vector>();
+    return aoc::parse_lines(input, [](std::string_view line) -> std::vector<int> {
+        std::vector<int> nums;
+        aoc::parse_all<int>(line, std::back_inserter(nums));
+        return nums;
+    });
 };
 
 auto part1 = [](std::vector<std::vector<int>> const& input) -> int
@@ -41,17 +40,19 @@ R"(0 3 6 9 12 15
 static_assert(part1(parse_input(test_data)) == 114);
 static_assert(part2(parse_input(test_data)) == 2);
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec09", solution);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec09", solution, argc, argv);
+}
 
-    auto const input = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
-}
\ No newline at end of file
+}
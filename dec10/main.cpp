@@ -9,53 +9,23 @@ enum class direction {
     north, south, east, west
 };
 
-struct position {
-    int x, y;
-
-    constexpr bool operator==(position const&) const = default;
-    constexpr auto operator<=>(position const&) const = default;
-
-    friend constexpr auto operator+(position p, direction d) -> position {
-        switch (d) {
-        case direction::north: --p.y; break;
-        case direction::south: ++p.y; break;
-        case direction::east: ++p.x; break;
-        case direction::west: --p.x; break;
-        }
-        return p;
-    }
-};
-
-struct grid_t {
-    std::string tiles;
-    int size; // assumed square
-
-    constexpr auto operator[](position pos) const -> char
-    {
-        if (pos.x >= 0 && pos.y >= 0 && pos.x < size && pos.y < size) {
-            return tiles[pos.y * size + pos.x];
-        } else {
-            return '.';
-        }
-    }
-
-    constexpr auto idx_to_pos(int idx) const -> position
-    {
-        return {.x = idx % size, .y = idx/size};
-    }
+using grid_t = aoc::grid2d<char>;
+using index_t = grid_t::index_type;
 
-    constexpr auto pos_to_idx(position pos) const -> int
-    {
-        return pos.y * size + pos.x;
+auto offset = [](grid_t const& grid, direction d) -> index_t
+{
+    switch (d) {
+    case direction::north: return grid.north();
+    case direction::south: return grid.south();
+    case direction::east: return grid.east();
+    case direction::west: return grid.west();
     }
+    throw std::runtime_error("Unknown direction");
 };
 
 auto parse_input = [](std::string_view input) -> grid_t
 {
-    return grid_t{
-        .tiles = flux::filter(input, flux::pred::neq('\n')).to<std::string>(),
-        .size = static_cast<int>(input.find('\n'))
-    };
+    return grid_t::from_text(input, '.');
 };
 
 auto tile_to_directions = [](char tile) -> std::pair<direction, direction>
@@ -72,14 +42,14 @@ auto tile_to_directions = [](char tile) -> std::pair<direction, direction>
     }
 };
 
-auto find_starting_direction = [](grid_t const& grid, position pos) -> direction
+auto find_starting_direction = [](grid_t const& grid, index_t idx) -> direction
 {
     constexpr std::array<std::pair<std::string_view, direction>, 3> table{{
         {"|7F", direction::north}, {"-J7", direction::east},
         {"|LJ", direction::south}
     }};
     for (auto [str, dir] : table) {
-        if (str.contains(grid[pos + dir])) {
+        if (str.contains(grid[idx + offset(grid, dir)])) {
             return dir;
         }
     }
@@ -88,21 +58,24 @@ auto find_starting_direction = [](grid_t const& grid, position pos) -> direction
 
 auto path_sequence = [](grid_t const& grid) -> flux::sequence auto
 {
-    auto generate_fn = [&grid](position pos, position prev) {
+    auto generate_fn = [&grid](index_t idx, index_t prev) {
         // Find the two directions we can go in from this tile
-        auto [next_dir1, next_dir2] = tile_to_directions(grid[pos]);
+        auto [next_dir1, next_dir2] = tile_to_directions(grid[idx]);
         // One of them leads where we just came from, so choose the other
-        auto dir = pos + next_dir1 != prev ? next_dir1 : next_dir2;
-        return std::pair{pos + dir, pos};
+        auto next = idx + offset(grid, next_dir1);
+        if (next == prev) {
+            next = idx + offset(grid, next_dir2);
+        }
+        return std::pair{next, idx};
     };
 
-    position start_pos = grid.idx_to_pos(grid.tiles.find('S'));
-    direction start_dir = find_starting_direction(grid, start_pos);
+    index_t start_idx = grid.find('S');
+    direction start_dir = find_starting_direction(grid, start_idx);
 
     return flux::unfold(flux::unpack(generate_fn),
-                        std::pair{start_pos + start_dir, start_pos})
+                        std::pair{start_idx + offset(grid, start_dir), start_idx})
                 .take_while([&grid](auto p) { return grid[p.first] != 'S'; })
-                .map(&std::pair<position, position>::first);
+                .map(&std::pair<index_t, index_t>::first);
 };
 
 auto part1 = [](grid_t const& grid) -> int
@@ -112,27 +85,32 @@ auto part1 = [](grid_t const& grid) -> int
 
 auto part2 = [](grid_t grid) -> int
 {
-    std::vector<position> path = path_sequence(grid).to<std::vector>();
+    std::vector<index_t> path = path_sequence(grid).to<std::vector>();
 
-    path.push_back(grid.idx_to_pos(grid.tiles.find('S')));
+    index_t const start_idx = grid.find('S');
+    path.push_back(start_idx);
     flux::sort(path);
-    grid.tiles.at(grid.tiles.find('S')) = 'F';
+    grid[start_idx] = 'F';
 
     int enclosed_count = 0;
 
-    for (int y : flux::iota(0, grid.size)) {
+    for (index_t y : flux::ints(0, grid.height())) {
         bool inside = false;
-        for (int x = 0; x < grid.size; ++x) {
-            if (std::ranges::binary_search(path, position{x, y})) {
-                char const tile = grid[{x, y}];
-                int const idx = grid.pos_to_idx({x, y});
+        for (index_t x = 0; x < grid.width(); ++x) {
+            index_t const idx = grid.index(x, y);
+
+            if (std::ranges::binary_search(path, idx)) {
+                char const tile = grid[idx];
 
                 if (tile == '|') {
                     inside = !inside;
                 } else if (tile == 'L' || tile == 'F') {
-                    auto nxt = grid.tiles.find_first_not_of('-', 1 + idx);
+                    index_t nxt = idx + 1;
+                    while (grid[nxt] == '-') {
+                        ++nxt;
+                    }
                     x += (nxt - idx);
-                    char const nxt_tile = grid[{x, y}];
+                    char const nxt_tile = grid[nxt];
                     if ((tile == 'L' && nxt_tile == '7') ||
                         (tile == 'F' && nxt_tile == 'J')) {
                         inside = !inside;
@@ -221,9 +199,15 @@ L---JF-JLJ.||-FJLJJ7
 L.L7LFJ|||||FJL7||LJ
 L7JLJL-JLJLJL--JLJ.L)";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec10", solution);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
     {
         static_assert(part1(parse_input(test_data1)) == 4);
@@ -237,13 +221,9 @@ int main(int argc, char** argv)
         static_assert(part2(parse_input(test_data8)) == 10);
     }
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec10", solution, argc, argv);
+}
 
-    grid_t input = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
-}
\ No newline at end of file
+}
@@ -15,38 +15,31 @@ auto distance = [](position from, position to) {
 template <i64 Expansion>
 auto parse_input = [](std::string_view input) -> std::vector<position>
 {
+    auto const grid = aoc::bitgrid::from_text(input, '#');
+    // Rows of the transposed grid are the columns of the original
+    auto const columns = grid.transposed();
+
+    // Work out where each column ends up after the empty ones are expanded
+    std::vector<i64> col_x(grid.width());
+    i64 x = 0;
+    for (auto i : flux::ints(0, grid.width())) {
+        col_x[i] = x;
+        x += columns.row_count(i) == 0 ? Expansion : 1;
+    }
+
     std::vector<position> galaxies;
-    auto n_cols = flux::find(input, '\n');
-    auto cols_with_galaxy = std::vector<bool>(n_cols, false);
     i64 y = 0;
-
-    for (auto line : flux::split_string(input, '\n')) {
-        i64 x = 0;
-        bool row_has_galaxy = false;
-        for (char c : line) {
-            if (c == '#') {
-                galaxies.push_back({x, y});
-                row_has_galaxy = true;
-                cols_with_galaxy[x] = true;
-            }
-            ++x;
+    for (auto row : flux::ints(0, grid.height())) {
+        if (grid.row_count(row) == 0) {
+            y += Expansion;
+            continue;
         }
-
-        ++y;
-        if (!row_has_galaxy) {
-            y += Expansion - 1;
-        }
-    }
-
-    // Now go through and "expand" the x-coords where there are no galaxies
-    for (auto i : flux::ints(0, n_cols).reverse()) {
-        if (!cols_with_galaxy[i]) {
-            for (auto& [x, _] : galaxies) {
-                if (x > i) {
-                    x += Expansion - 1;
-                }
+        for (auto col : flux::ints(0, grid.width())) {
+            if (grid.test(col, row)) {
+                galaxies.push_back({col_x[col], y});
             }
         }
+        ++y;
     }
 
     return galaxies;
@@ -85,17 +78,19 @@ static_assert(calculate_distances<2>(test_data) == 374);
 static_assert(calculate_distances<10>(test_data) == 1030);
 static_assert(calculate_distances<100>(test_data) == 8410);
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = aoc::raw_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec11", solution);
+
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec11", solution, argc, argv);
+}
 
-    auto const input = aoc::string_from_file(argv[1]);
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
-}
\ No newline at end of file
+}
@@ -12,22 +12,31 @@ struct row {
 
 auto parse_input = [](std::string_view input) -> std::vector<row>
 {
-    return flux::split_string(input, '\n')
-            .filter([](std::string_view line) { return !line.empty(); })
-            .map([](std::string_view line) -> row {
-                   auto sp = line.find(' ');
-                   return row {
-                       .record = std::string(line.substr(0, sp)),
-                       .counts = flux::split(line.substr(sp+1), ',')
-                                    .map(aoc::parse<int>)
-                                    .to<std::vector>()
-                   };
-             })
-            .to<std::vector>();
+    return aoc::parse_lines(input, [](std::string_view line) -> row {
+        auto sp = line.find(' ');
+        return row {
+            .record = std::string(line.substr(0, sp)),
+            .counts = flux::split(line.substr(sp+1), ',')
+                         .map(aoc::parse<int>)
+                         .to<std::vector>()
+        };
+    });
 };
 
-// Urgh, why doesn't C++ provide a hash specialisation for tuple? :(
-using cache_t = std::map<std::tuple<int, int, int>, i64>;
+struct cache_key {
+    int record_idx;
+    int hash_count;
+    int group_idx;
+
+    friend auto operator==(cache_key const&, cache_key const&) -> bool = default;
+
+    friend auto hash_members(cache_key const& k)
+    {
+        return std::tie(k.record_idx, k.hash_count, k.group_idx);
+    }
+};
+
+using cache_t = aoc::memo<cache_key, i64>;
 
 auto analyse_row_recursive(std::string const& record,
                            std::vector<int> const& groups,
@@ -36,8 +45,8 @@ auto analyse_row_recursive(std::string const& record,
                            int hash_count,
                            int group_idx) -> i64
 {
-    if (auto iter = cache.find({record_idx, hash_count, group_idx}); iter != cache.end()) {
-        return iter->second;
+    if (auto cached = cache.find({record_idx, hash_count, group_idx})) {
+        return *cached;
     }
 
     // We have reached the end of this record
@@ -74,7 +83,7 @@ auto analyse_row_recursive(std::string const& record,
         }
     }
 
-    cache[{record_idx, hash_count, group_idx}] = total;
+    cache.insert({record_idx, hash_count, group_idx}, total);
 
     return total;
 }
@@ -103,14 +112,10 @@ auto part2 = [](std::vector<row> input) -> i64
         counts = flux::ref(counts).cycle(5).to<std::vector>();
     }
 
-    std::vector<i64> totals(input.size());
-
-#pragma omp parallel for
-    for (size_t i = 0; i < input.size(); i++) {
-        totals.at(i) = analyse_row(input.at(i));
-    }
-
-    return flux::sum(totals);
+    // Rows take very different amounts of time, which the pool balances
+    return aoc::parallel_reduce(0, flux::size(input), i64{0}, [&](i64 i) {
+        return analyse_row(input.at(i));
+    });
 };
 
 constexpr auto& test_data1 =
@@ -129,20 +134,23 @@ R"(???.### 1,1,3
 ????.######..#####. 1,6,5
 ?###???????? 3,2,1)";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec12", solution, 10);
+
+auto day_main(int argc, char** argv) -> int
 {
     assert(part1(parse_input(test_data1)) == 6);
     assert(part1(parse_input(test_data2)) == 21);
     assert(part2(parse_input(test_data2)) == 525152);
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec12", solution, argc, argv);
+}
+
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    auto input = parse_input(aoc::string_from_file(argv[1]));
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
-}
\ No newline at end of file
+}
@@ -5,7 +5,8 @@ namespace {
 
 using i64 = std::int64_t;
 
-using grid_t = std::vector<std::string>;
+// Each row is a view into the input, so no copying of lines is needed
+using grid_t = std::vector<std::string_view>;
 
 auto parse_input = [](std::string_view input) -> std::vector<grid_t>
 {
@@ -88,17 +89,19 @@ static_assert([] {
         && part2(test_input) == 400;
 }());
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec13", solution);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec13", solution, argc, argv);
+}
 
-    auto const input = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
-}
\ No newline at end of file
+}
@@ -7,112 +7,87 @@ namespace {
 
 using i64 = std::int64_t;
 
-struct grid2d {
-    std::string data;
-    i64 size; // assumed square
+using grid_t = aoc::grid2d<char>;
+using index_t = grid_t::index_type;
 
-    constexpr auto operator[](i64 idx) -> char& { return data.at(idx); }
-    constexpr auto operator[](i64 idx) const -> char { return data.at(idx); }
-
-    // Returns a sequence-of-sequences of the row indices
-    constexpr auto rows() const -> flux::sequence auto
-    {
-        return flux::ints(0, size * size).chunk(size);
-    }
-
-    // Returns a sequence-of-sequences of the column indices
-    constexpr auto columns() const -> flux::sequence auto
-    {
-        return flux::ints(0, size * size)
-                .map([sz = size](i64 i) { return (i % sz) * sz + (i/sz); })
-                .chunk(size);
-    }
-};
-
-auto parse_input = [](std::string_view input) -> grid2d
+auto parse_input = [](std::string_view input) -> grid_t
 {
-    return grid2d{
-        .data = flux::filter(input, flux::pred::neq('\n')).to<std::string>(),
-        .size = flux::find(input, '\n')
-    };
+    return grid_t::from_text(input, '#');
 };
 
-// Roll a single row/column, mutating the grid in-place
-auto do_roll = [](grid2d& grid, flux::sequence auto indices)
+// Roll a single row/column of count cells, mutating the grid in-place. Rocks
+// move towards start, and we scan away from it in steps of step.
+auto do_roll = [](grid_t& grid, index_t start, index_t step, index_t count)
 {
-    auto col = flux::map(indices, [&grid](i64 i) -> char& { return grid[i]; });
-
-    for (auto pos = col.first(); !col.is_last(pos); col.inc(pos)) {
-        if (col[pos] == '.') {
-            // fast-forward until we find the next non-empty position
-            auto nonempty = flux::slice(col, col.next(pos), col.last())
-                                .find_if_not(flux::pred::eq('.'));
-            if (col.is_last(nonempty)) {
-                break;
-            } else if (col[nonempty] == 'O') {
-                flux::swap_at(col, pos, nonempty);
-            } else if (col[nonempty] == '#') {
-                pos = nonempty;
-            }
+    // The next position a rolling rock will come to rest
+    index_t free = start;
+    index_t idx = start;
+
+    for (auto _ : flux::ints(0, count)) {
+        char const c = grid[idx];
+        if (c == '#') {
+            free = idx + step;
+        } else if (c == 'O') {
+            grid[idx] = '.';
+            grid[free] = 'O';
+            free += step;
         }
+        idx += step;
     }
 };
 
-auto calculate_score = [](grid2d const& grid) -> i64
+auto calculate_score = [](grid_t const& grid) -> i64
 {
-    return grid.columns()
-            .map([&grid](auto indices) {
-                return flux::zip(indices, flux::ints(0, grid.size + 1).reverse())
-                    .filter([&grid](auto const& p) { return grid[p.first] == 'O'; })
-                    .map([](auto const& p) -> i64 { return p.second; })
-                    .sum();
-            })
+    return grid.indices()
+            .filter([&grid](index_t idx) { return grid[idx] == 'O'; })
+            .map([&grid](index_t idx) { return grid.height() - grid.y_of(idx); })
             .sum();
 };
 
-auto part1 = [](grid2d grid) -> i64
+auto roll_north = [](grid_t& grid)
+{
+    for (auto x : flux::ints(0, grid.width())) {
+        do_roll(grid, grid.index(x, 0), grid.south(), grid.height());
+    }
+};
+
+auto part1 = [](grid_t grid) -> i64
 {
     // Roll the grid north once
-    grid.columns().for_each([&grid](auto col) { do_roll(grid, col); });
+    roll_north(grid);
     return calculate_score(grid);
 };
 
 // Rolls the grid in four directions, mutating it in-place
-auto roll_grid = [](grid2d& grid)
+auto roll_grid = [](grid_t& grid)
 {
-    // Roll north
-    grid.columns().for_each([&grid](auto col) { do_roll(grid, col); });
+    roll_north(grid);
     // Roll west
-    grid.rows().for_each([&grid](auto row) { do_roll(grid, row); });
+    for (auto y : flux::ints(0, grid.height())) {
+        do_roll(grid, grid.index(0, y), grid.east(), grid.width());
+    }
     // Roll south
-    grid.columns().for_each([&grid](auto col) { do_roll(grid, flux::reverse(col)); });
+    for (auto x : flux::ints(0, grid.width())) {
+        do_roll(grid, grid.index(x, grid.height() - 1), grid.north(), grid.height());
+    }
     // Roll east
-    grid.rows().for_each([&grid](auto row) { do_roll(grid, flux::reverse(row)); });
+    for (auto y : flux::ints(0, grid.height())) {
+        do_roll(grid, grid.index(grid.width() - 1, y), grid.west(), grid.width());
+    }
 };
 
-auto part2 = [](grid2d grid) -> i64
+auto part2 = [](grid_t grid) -> i64
 {
-    ankerl::unordered_dense::map<std::string, i64> states;
-    states[grid.data] = 0;
-
-    i64 loop_entry = -1;
-    i64 loop_len = -1;
-
-    for (i64 i : flux::ints(1)) {
-        roll_grid(grid);
+    auto fingerprint = [](grid_t const& g) {
+        auto const& cells = g.data();
+        return ankerl::unordered_dense::hash<std::string_view>{}(
+            std::string_view(cells.data(), cells.size()));
+    };
 
-        auto [iter, inserted] = states.try_emplace(grid.data, i);
-        if (!inserted) {
-            //fmt::println("Found repeated state after {} cycles (first was {})",
-            //             i, iter->second);
-            loop_entry = iter->second;
-            loop_len = i - loop_entry;
-            break;
-        }
-    }
+    auto const [tail, period] = aoc::find_cycle(grid, roll_grid, fingerprint);
 
     // Perform a few more iterations to get to the right point in the cycle
-    i64 remaining = (1'000'000'000 - loop_entry) % loop_len;
+    i64 remaining = (1'000'000'000 - tail) % period;
     for (i64 _ : flux::ints(0, remaining)) {
         roll_grid(grid);
     }
@@ -132,9 +107,15 @@ O.#..O.#.#
 #....###..
 #OO..#....)";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec14", solution);
+
+auto day_main(int argc, char** argv) -> int
 {
     {
         auto test_input = parse_input(test_data);
@@ -142,12 +123,9 @@ int main(int argc, char** argv)
         assert(part2(test_input) == 64);
     }
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec14", solution, argc, argv);
+}
+
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    auto input = parse_input(aoc::string_from_file(argv[1]));
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
-}
\ No newline at end of file
+}
@@ -23,33 +23,33 @@ struct lens {
     int focal_length;
 };
 
-auto part2 = [](std::string_view input) -> int
+using boxes_t = std::array<std::vector<lens>, 256>;
+
+// Performs a single step of the initialisation sequence
+auto arrange_boxes = [](boxes_t& boxes, std::string_view str)
 {
-    std::array<std::vector<lens>, 256> boxes;
+    auto const op = str.find_first_of("=-");
+    auto label = str.substr(0, op);
+    auto& box = boxes.at(hash_string(label));
+    auto iter = std::ranges::find(box, label, &lens::label);
+
+    if (str.at(op) == '-') {
+        if (iter != box.end()) {
+            box.erase(iter);
+        }
+    } else if (str.at(op) == '=') {
+        int len = aoc::parse<int>(str.substr(op + 1));
 
-    // Arrange all the boxes
-    for (std::string_view str : flux::split_string(input, ',')) {
-        auto const op = str.find_first_of("=-");
-        auto label = str.substr(0, op);
-        auto& box = boxes.at(hash_string(label));
-        auto iter = std::ranges::find(box, label, &lens::label);
-
-        if (str.at(op) == '-') {
-            if (iter != box.end()) {
-                box.erase(iter);
-            }
-        } else if (str.at(op) == '=') {
-            int len = aoc::parse<int>(str.substr(op + 1));
-
-            if (iter != box.end()) {
-                iter->focal_length = len;
-            } else {
-                box.emplace_back(std::string(label), len);
-            }
+        if (iter != box.end()) {
+            iter->focal_length = len;
+        } else {
+            box.emplace_back(std::string(label), len);
         }
     }
+};
 
-    // Calculate the score
+auto focusing_power = [](boxes_t const& boxes) -> int
+{
     int score = 0;
 
     for (auto const& [box, box_num] : flux::zip(flux::ref(boxes), flux::ints(1))) {
@@ -61,23 +61,72 @@ auto part2 = [](std::string_view input) -> int
     return score;
 };
 
+auto part2 = [](std::string_view input) -> int
+{
+    boxes_t boxes;
+    for (std::string_view str : flux::split_string(input, ',')) {
+        arrange_boxes(boxes, str);
+    }
+    return focusing_power(boxes);
+};
+
+// Both parts in a single pass over the steps, so that input piped to stdin
+// never has to be held in memory
+constexpr auto streaming = aoc::streaming_solution{
+    .delimiter = ',',
+    .part1 = aoc::record_fold{
+        .init = 0,
+        .step = [](int& sum, std::string_view str) { sum += hash_string(str); }
+    },
+    .part2 = aoc::record_fold{
+        .init = boxes_t{},
+        .step = arrange_boxes,
+        .finish = focusing_power
+    }
+};
+
 constexpr auto& test_data = "rn=1,cm-,qp=3,cm=2,qp-,pc=4,ot=9,ab=5,pc-,pc=6,ot=7";
 
 static_assert(hash_string("HASH") == 52);
 static_assert(part1(test_data) == 1320);
 static_assert(part2(test_data) == 145);
+static_assert(aoc::fold_records(streaming.part1, ',', test_data) == 1320);
+static_assert(aoc::fold_records(streaming.part2, ',', test_data) == 145);
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = aoc::raw_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec15", solution);
+
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
+    // Giving up partway through a pipe which is still open mustn't wait for
+    // the rest of it, which may never come
+    {
+        int fds[2];
+        [[maybe_unused]] int const rc = ::pipe(fds);
+        assert(rc == 0);
+        std::string_view const head = "rn=1,cm-,";
+        [[maybe_unused]] auto const written = ::write(fds[1], head.data(), head.size());
+        bool threw = false;
+        try {
+            aoc::stream_records(fds[0], ',', [](std::string_view) {
+                throw std::runtime_error("stop");
+            });
+        } catch (std::runtime_error const&) {
+            threw = true;
+        }
+        assert(threw);
+        ::close(fds[0]);
+        ::close(fds[1]);
     }
 
-    auto const input = aoc::string_from_file(argv[1]);
+    return aoc::run("dec15", solution, argc, argv, streaming);
+}
 
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
-}
\ No newline at end of file
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
+
+}
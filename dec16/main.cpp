@@ -1,9 +1,6 @@
 
 #include "../aoc.hpp"
 
-#include <set>
-#include <stack>
-
 namespace {
 
 using i64 = std::int64_t;
@@ -12,81 +9,47 @@ enum class direction : std::uint8_t {
     north, east, south, west
 };
 
-struct position {
-    i64 x, y;
-
-    constexpr auto operator+=(direction d) -> position&
-    {
-        switch(d) {
-        case direction::north: --y; break;
-        case direction::east: ++x; break;
-        case direction::south: ++y; break;
-        case direction::west: --x; break;
-        }
-        return *this;
-    }
-
-    auto operator==(position const&) const -> bool = default;
-    auto operator<=>(position const&) const = default;
-
-    friend constexpr auto operator+(position p, direction d) -> position
-    {
-        return p += d;
-    }
-
-};
-
-struct grid2d {
-    std::string data;
-    i64 size; // assumed square
-
-    constexpr auto to_idx(position pos) const -> i64
-    {
-        return pos.y * size + pos.x;
-    }
-
-    constexpr auto operator[](position pos) const -> char
-    {
-        return data.at(to_idx(pos));
-    }
+using grid_t = aoc::grid2d<char>;
+using index_t = grid_t::index_type;
 
-    constexpr auto in_bounds(position pos) const -> bool
-    {
-        return pos.x >= 0 && pos.x < size && pos.y >= 0 && pos.y < size;
-    }
-};
+// Marks the tiles just outside the grid
+constexpr char edge = ' ';
 
-auto parse_input = [](std::string_view input) -> grid2d
+auto parse_input = [](std::string_view input) -> grid_t
 {
-    return grid2d{
-        .data = flux::filter(input, flux::pred::neq('\n')).to<std::string>(),
-        .size = flux::find(input, '\n')
-    };
+    return grid_t::from_text(input, edge);
 };
 
-auto fire_beam = [](grid2d const& grid, position start_pos, direction start_dir) -> i64
+auto fire_beam = [](grid_t const& grid, index_t start_pos, direction start_dir) -> i64
 {
-    std::set<std::pair<position, direction>> past_positions;
-    std::vector<bool> energised(grid.data.size(), false);
+    auto const offsets = grid.offsets(); // in the same order as direction
+
+    // One bit for each direction a beam has passed through each tile in.
+    // Part 2 fires hundreds of beams (and --batch mode many more), so this
+    // and the stack of beams keep their memory between calls on each thread.
+    thread_local std::vector<std::uint8_t> seen;
+    seen.assign(grid.data().size(), 0);
 
-    std::stack<std::pair<position, direction>> beams;
-    beams.push({start_pos, start_dir});
+    thread_local std::vector<std::pair<index_t, direction>> beams;
+    beams.clear();
+    beams.push_back({start_pos, start_dir});
 
     while (!beams.empty()) {
-        auto [pos, dir] = beams.top();
-        beams.pop();
+        auto [pos, dir] = beams.back();
+        beams.pop_back();
 
         while (true) {
-            if (!grid.in_bounds(pos)) {
+            char c = grid[pos];
+
+            if (c == edge) {
                 break;
             }
 
-            if (auto [iter, inserted] = past_positions.insert({pos, dir}); !inserted) {
+            auto const dir_bit = static_cast<std::uint8_t>(1u << int(dir));
+            if (seen[pos] & dir_bit) {
                 break;
             }
-            energised.at(grid.to_idx(pos)) = true;
-
-            char c = grid[pos];
+            seen[pos] |= dir_bit;
 
             switch (c) {
             case '.':
@@ -116,7 +79,7 @@ auto fire_beam = [](grid2d const& grid, position start_pos, direction start_dir)
                 case direction::west: break;
                 case direction::north: [[fallthrough]];
                 case direction::south: {
-                    beams.push({pos + direction::west, direction::west});
+                    beams.push_back({pos + grid.west(), direction::west});
                     dir = direction::east;
                 }
                 }
@@ -128,7 +91,7 @@ auto fire_beam = [](grid2d const& grid, position start_pos, direction start_dir)
                 case direction::south: break;
                 case direction::east: [[fallthrough]];
                 case direction::west: {
-                    beams.push({pos + direction::north, direction::north});
+                    beams.push_back({pos + grid.north(), direction::north});
                     dir = direction::south;
                 }
                 }
@@ -137,31 +100,31 @@ auto fire_beam = [](grid2d const& grid, position start_pos, direction start_dir)
             default: throw std::runtime_error("Unrecognised character in grid!");
             }
 
-            pos += dir;
+            pos += offsets[int(dir)];
         }
     }
 
-    return flux::from_crange(energised).count_eq(true);
+    return flux::count_if(seen, [](std::uint8_t s) { return s != 0; });
 };
 
-constexpr auto part1 = [](grid2d const& grid) -> i64
+constexpr auto part1 = [](grid_t const& grid) -> i64
 {
-    return fire_beam(grid, {0, 0}, direction::east);
+    return fire_beam(grid, grid.index(0, 0), direction::east);
 };
 
-constexpr auto part2 = [](grid2d const& grid) -> i64
+constexpr auto part2 = [](grid_t const& grid) -> i64
 {
-    auto top = flux::ints(0, grid.size).map([](i64 i) {
-        return std::pair(position{i, 0}, direction::south);
+    auto top = flux::ints(0, grid.width()).map([&grid](i64 i) {
+        return std::pair(grid.index(i, 0), direction::south);
     });
-    auto bottom = flux::ints(0, grid.size).map([sz = grid.size](i64 i) {
-        return std::pair(position{i, sz}, direction::north);
+    auto bottom = flux::ints(0, grid.width()).map([&grid](i64 i) {
+        return std::pair(grid.index(i, grid.height()), direction::north);
     });
-    auto left = flux::ints(0, grid.size).map([](i64 i) {
-        return std::pair(position{0, i}, direction::east);
+    auto left = flux::ints(0, grid.height()).map([&grid](i64 i) {
+        return std::pair(grid.index(0, i), direction::east);
     });
-    auto right = flux::ints(0, grid.size).map([sz = grid.size](i64 i) {
-        return std::pair(position{sz, i}, direction::west);
+    auto right = flux::ints(0, grid.height()).map([&grid](i64 i) {
+        return std::pair(grid.index(grid.width(), i), direction::west);
     });
 
     return flux::chain(std::move(top), std::move(bottom), std::move(left), std::move(right))
@@ -182,9 +145,15 @@ R"(.|...\....
 .|....-|.\
 ..//.|....)";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec16", solution, 5);
+
+auto day_main(int argc, char** argv) -> int
 {
     {
         auto const test_input = parse_input(test_data);
@@ -192,13 +161,9 @@ int main(int argc, char** argv)
         assert(part2(test_input) == 51);
     }
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec16", solution, argc, argv);
+}
 
-    auto const input = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
-}
\ No newline at end of file
+}
@@ -1,182 +1,80 @@
 
 #include "../aoc.hpp"
 
-#include <queue>
-#include <set>
-
 namespace {
 
 using i64 = std::int64_t;
 
-enum class direction : std::uint8_t {
-    north, east, south, west
-};
-
-struct position {
-    i64 x, y;
-
-    bool operator==(position const&) const = default;
-    auto operator<=>(position const&) const = default;
-
-    friend constexpr auto operator+(position p, direction d) -> position
-    {
-        switch (d){
-        case direction::north: --p.y; break;
-        case direction::east: ++p.x; break;
-        case direction::south: ++p.y; break;
-        case direction::west: --p.x; break;
-        }
-        return p;
-    }
-};
-
-struct grid2d {
-    std::vector<int> data;
-    i64 width;
-    i64 height;
+// Heat losses are 1-9, so a zero marks the tiles just outside the grid
+using grid_t = aoc::grid2d<std::uint8_t>;
+using index_t = grid_t::index_type;
 
-    constexpr auto operator[](position pos) const -> int
-    {
-        return data.at(pos.y * width + pos.x);
-    }
-
-    constexpr auto in_bounds(position pos) const -> bool
-    {
-        return pos.x >= 0 && pos.x < width && pos.y >= 0 && pos.y < height;
-    }
-};
-
-auto parse_input = [](std::string_view input) -> grid2d
+auto parse_input = [](std::string_view input) -> grid_t
 {
-    return grid2d{
-        .data = flux::filter(input, flux::pred::neq('\n'))
-                    .map([](char c) { return c - '0'; })
-                    .to<std::vector>(),
-        .width = flux::find(input, '\n'),
-        .height = flux::count_eq(input, '\n')
-    };
+    return grid_t::from_text(input, 0, [](char c) { return c - '0'; });
 };
 
-template <typename G>
-concept Graph =
-    std::regular<typename G::node_type> &&
-    std::regular<typename G::distance_type> &&
-    std::totally_ordered<typename G::distance_type> &&
-    requires (G const& g, typename G::node_type n) {
-        { g.neighbours(n) } -> flux::sequence; // of pair<node_type, distance_type>
-        { g.should_exit(n) } -> std::same_as<bool>;
-    };
-
-auto dijkstra =
-[]<Graph G>(G const& graph, G::node_type start)
-    -> std::map<typename G::node_type, typename G::distance_type>
-{
-    using node_t = G::node_type;
-    using dist_t = G::distance_type;
-    using queue_t = std::priority_queue<
-                        std::pair<dist_t, node_t>,
-                        std::vector<std::pair<dist_t, node_t>>,
-                        std::greater<>>;
-    using map_t = std::map<node_t, dist_t>;
-
-    queue_t queue{};
-    map_t dists;
-
-    queue.push({0, start});
-    dists[start] = dist_t{};
-
-    while (!queue.empty()) {
-        auto [_, current] = queue.top();
-        queue.pop();
-
-        if (graph.should_exit(current)) {
-            break;
-        }
-
-        dist_t current_dist= dists.find(current)->second;
-
-        for (auto const& [next_node, next_dist] : graph.neighbours(current)) {
-            dist_t new_dist = dists[current] + next_dist;
-            if (auto iter = dists.find(next_node); iter == dists.cend() || new_dist < iter->second) {
-                dists[next_node] = new_dist;
-                queue.push({new_dist, next_node});
-            }
-        }
-    }
-
-    return dists;
-};
+// Each node is a tile along with the axis we were moving along when we got
+// there, packed as tile * 2 + axis. Since we have to turn at every node, the
+// direction within the axis doesn't matter.
+constexpr i64 horizontal = 0;
+constexpr i64 vertical = 1;
 
 template <i64 MinDist, i64 MaxDist>
 struct crucible_graph {
-    grid2d const& grid;
-
-    struct node_type {
-        position pos{};
-        flux::optional<direction> dir;
-
-        bool operator==(node_type const&) const = default;
-        auto operator<=>(node_type const&) const = default;
-    };
+    grid_t const& grid;
+    index_t target;
 
+    using node_type = i64;
     using distance_type = i64;
 
-    auto neighbours(node_type const& n) const
-       -> std::vector<std::pair<node_type, distance_type>>
+    static constexpr distance_type max_weight = 9 * MaxDist;
+
+    auto node_count() const -> i64
     {
-        std::vector<std::pair<node_type, distance_type>> out;
-
-        auto next_dirs =
-            flux::ints(0, 4)
-              .filter([&](i64 d) {
-                if (n.dir.has_value()) {
-                    return flux::pred::even(d) != flux::pred::even(int(*n.dir));
-                } else {
-                    return true;
-                }
-              })
-              .map([](i64 d) { return static_cast<direction>(d); });
+        return 2 * flux::size(grid.data());
+    }
 
-        for (direction next_dir : next_dirs) {
-            auto next_pos = n.pos;
+    void for_each_neighbour(node_type n, auto&& fn) const
+    {
+        index_t const pos = n / 2;
+        i64 const next_axis = n % 2 == horizontal ? vertical : horizontal;
+        auto const steps = next_axis == horizontal
+                               ? std::array{grid.east(), grid.west()}
+                               : std::array{grid.north(), grid.south()};
+
+        for (index_t step : steps) {
+            auto next_pos = pos;
             auto cost = 0;
 
             for (auto i : flux::ints(1, MaxDist + 1)) {
-                next_pos = next_pos + next_dir;
-                if (!grid.in_bounds(next_pos)) {
+                next_pos += step;
+                if (grid[next_pos] == 0) {
                     break;
                 }
                 cost += grid[next_pos];
                 if (i >= MinDist) {
-                    out.emplace_back(
-                        node_type{.pos = next_pos, .dir = flux::optional(next_dir)}, cost);
+                    fn(next_pos * 2 + next_axis, cost);
                 }
             }
         }
-
-        return out;
     }
 
-    auto should_exit(node_type const& n) const -> bool
+    auto should_exit(node_type n) const -> bool
     {
-        return n.pos == position{grid.width - 1, grid.height - 1};
+        return n / 2 == target;
     }
 };
 
 template <int MinDist, int MaxDist>
-auto calculate = [](grid2d const& grid) -> i64
+auto calculate = [](grid_t const& grid) -> i64
 {
-    crucible_graph<MinDist, MaxDist> graph{grid};
+    index_t const target = grid.index(grid.width() - 1, grid.height() - 1);
+    crucible_graph<MinDist, MaxDist> graph{grid, target};
 
-    auto dists = dijkstra(graph, {.pos = {0, 0}});
-
-    return flux::from_crange(dists)
-        .filter([&grid](auto const& pair) {
-            return pair.first.pos == position{grid.width - 1, grid.height - 1};
-        })
-        .map([](auto const& pair) { return pair.second; })
-        .min()
-        .value();
+    // We can set off along either axis
+    index_t const start = grid.index(0, 0);
+    return aoc::dijkstra(graph, {start * 2 + horizontal, start * 2 + vertical}).value();
 };
 
 auto const part1 = calculate<1, 3>;
@@ -206,9 +104,15 @@ R"(111111111111
 999999999991
 )";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec17", solution, 10);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
     {
         auto const test_grid = parse_input(test_data);
@@ -219,13 +123,9 @@ int main(int argc, char** argv)
         fmt::println("Part 2 test2: {}", part2(test_grid2));
     }
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec17", solution, argc, argv);
+}
 
-    auto const grid = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(grid));
-    fmt::println("Part 2: {}", part2(grid));
-}
\ No newline at end of file
+}
@@ -47,29 +47,44 @@ auto parse_line_p2 = [](std::string_view line) -> std::pair<vec2, i64>
     throw std::runtime_error("Unknown direction");
 };
 
+using area_state = std::pair<vec2, i64>;
+
+// The shoelace formula (plus the perimeter), one line at a time
+template <auto& ParseFn>
+constexpr auto area_fold = aoc::record_fold{
+    .init = area_state{},
+    .step = [](area_state& s, std::string_view line) {
+        if (line.empty()) {
+            return;
+        }
+
+        auto& [p1, area] = s;
+        auto [diff, len] = ParseFn(line);
+        auto p2 = p1 + diff;
+
+        area += len + (p1.x * p2.y - p2.x * p1.y);
+        p1 = p2;
+    },
+    .finish = [](area_state s) -> i64 { return 1 + s.second/2; }
+};
+
 template <auto& ParseFn>
 auto calculate_area = [](std::string_view input) -> i64
 {
-    using state = std::pair<vec2, i64>;
-
-    auto area = flux::split_string(input, '\n')
-        .filter(std::not_fn(flux::is_empty))
-        .fold([](state s, std::string_view line) -> state {
-             auto [p1, area] = s;
-             auto [diff, len] = ParseFn(line);
-             auto p2 = p1 + diff;
-
-             area += len + (p1.x * p2.y - p2.x * p1.y);
-
-             return {p2, area};
-         }, state{}).second;
-
-    return 1 + area/2;
+    return aoc::fold_records(area_fold<ParseFn>, '\n', input);
 };
 
 auto part1 = calculate_area<parse_line_p1>;
 auto part2 = calculate_area<parse_line_p2>;
 
+// Both parts in a single pass over the lines, so that input piped to stdin
+// never has to be held in memory
+constexpr auto streaming = aoc::streaming_solution{
+    .delimiter = '\n',
+    .part1 = area_fold<parse_line_p1>,
+    .part2 = area_fold<parse_line_p2>
+};
+
 constexpr auto& test_data =
 R"(R 6 (#70c710)
 D 5 (#0dc571)
@@ -89,17 +104,19 @@ U 2 (#7a21e3))";
 static_assert(part1(test_data) == 62);
 static_assert(part2(test_data) == 952408144115);
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = aoc::raw_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec18", solution);
+
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec18", solution, argc, argv, streaming);
+}
 
-    auto const input_str = aoc::string_from_file(argv[1]);
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(input_str));
-    fmt::println("Part 2: {}", part2(input_str));
-}
\ No newline at end of file
+}
@@ -1,27 +1,30 @@
 
 #include "../aoc.hpp"
 
-#include <ankerl/unordered_dense.h>
 #include <ctre.hpp>
 
 namespace {
 
 using i64 = std::int64_t;
 
+using id_type = aoc::interner::id_type;
+
+// Workflows are numbered as they're parsed, after these two
+constexpr id_type accept = 0;
+constexpr id_type reject = 1;
+
 struct rule {
     char cat; // x, m, a or s
     char op; // < or >
     int value;
-    std::string dest;
+    id_type dest;
 };
 
 struct workflow {
-    std::vector<rule> rules;
-    std::string fallback;
+    std::pmr::vector<rule> rules;
+    id_type fallback;
 };
 
-using workflows_map = ankerl::unordered_dense::map<std::string, workflow>;
-
 using part = std::array<int, 4>;
 
 struct range {
@@ -30,39 +33,69 @@ struct range {
 
 using part_range = std::array<range, 4>;
 
-auto parse_rules = [](std::string_view str) -> std::vector<rule>
+// The lists of rules live in an arena, which is declared first so that it
+// outlives them
+struct input_t {
+    aoc::arena arena;
+    std::pmr::vector<workflow> workflows; // indexed by ID
+    id_type start;
+    std::vector<part> parts;
+};
+
+auto parse_rules = [](std::string_view str, aoc::interner& names,
+                      std::pmr::vector<rule>& rules)
 {
     constexpr auto& rule_regex =
         ctre::match<R"(([xmas])([<>])(\d+):(\w+))">;
 
-    return flux::split_string(str, ',')
-            .map([](std::string_view r) -> rule {
-                auto [m, cat, op, value, dest] = rule_regex(r);
-                assert(m);
-                return rule{
-                    .cat = cat.view().at(0),
-                    .op = op.view().at(0),
-                    .value = value.to_number(),
-                    .dest = dest.str()
-                };
-            })
-            .to<std::vector>();
+    // Nothing given back to an arena is reused, so avoid growing the vector
+    rules.reserve(1 + std::ranges::count(str, ','));
+    flux::split_string(str, ',').for_each([&](std::string_view r) {
+        auto [m, cat, op, value, dest] = rule_regex(r);
+        assert(m);
+        rules.push_back(rule{
+            .cat = cat.view().at(0),
+            .op = op.view().at(0),
+            .value = value.to_number(),
+            .dest = names.intern(dest.view())
+        });
+    });
 };
 
-auto parse_workflows = [](std::string_view str) -> workflows_map
+auto parse_workflows = [](std::string_view str, aoc::arena const& arena)
+    -> std::pair<std::pmr::vector<workflow>, id_type>
 {
     constexpr auto& workflow_regex =
         ctre::match<R"((\w+)\{(.*),(\w+)\})">;
 
-    return flux::split_string(str, '\n')
-            .map([](std::string_view line) -> std::pair<std::string, workflow> {
-                   auto [m, name, rules, fallback] = workflow_regex(line);
-                   assert(m);
-                   return std::pair(name.str(),
-                                    workflow{.rules = parse_rules(rules),
-                                             .fallback = fallback.str()});
-             })
-            .to<workflows_map>();
+    auto const lines = flux::split_string(str, '\n').to<std::vector<std::string_view>>();
+
+    aoc::interner names;
+    names.intern("A");
+    names.intern("R");
+
+    // Number every workflow before reading any rules, so that the vector of
+    // workflows never has to grow
+    for (std::string_view line : lines) {
+        names.intern(line.substr(0, line.find('{')));
+    }
+
+    std::pmr::vector<workflow> workflows(arena.allocator<workflow>());
+    workflows.reserve(names.size());
+    for (auto _ : flux::ints(0, names.size())) {
+        workflows.push_back(workflow{.rules = std::pmr::vector<rule>(arena.allocator<rule>()),
+                                     .fallback = reject});
+    }
+
+    for (std::string_view line : lines) {
+        auto [m, name, rules, fallback] = workflow_regex(line);
+        assert(m);
+        workflow& w = workflows.at(names.find(name.view()).value());
+        parse_rules(rules, names, w.rules);
+        w.fallback = names.intern(fallback.view());
+    }
+
+    return {std::move(workflows), names.find("in").value()};
 };
 
 auto parse_parts = [](std::string_view str) -> std::vector<part>
@@ -79,13 +112,18 @@ auto parse_parts = [](std::string_view str) -> std::vector<part>
             .to<std::vector>();
 };
 
-auto parse_input = [](std::string_view input)
-    -> std::pair<workflows_map, std::vector<part>>
+auto parse_input = [](std::string_view input) -> input_t
 {
     auto blank_line = input.find("\n\n");
 
-    return {parse_workflows(input.substr(0, blank_line)),
-            parse_parts(input.substr(blank_line + 2))};
+    // Moving the containers keeps them pointing at the same arena, but
+    // assigning to them wouldn't, so build the whole struct in one go
+    auto arena = aoc::arena(input.size());
+    auto [workflows, start] = parse_workflows(input.substr(0, blank_line), arena);
+    return input_t{.arena = std::move(arena),
+                   .workflows = std::move(workflows),
+                   .start = start,
+                   .parts = parse_parts(input.substr(blank_line + 2))};
 };
 
 auto category_to_dim = [](char c) -> int {
@@ -98,16 +136,16 @@ auto category_to_dim = [](char c) -> int {
     }
 };
 
-auto process_flows_recursive(std::string const& name, part const& part,
-                             workflows_map const& workflows) -> bool
+auto process_flows_recursive(id_type id, part const& part,
+                             std::pmr::vector<workflow> const& workflows) -> bool
 {
-    if (name == "A") {
+    if (id == accept) {
         return true;
-    } else if (name == "R") {
+    } else if (id == reject) {
         return false;
     }
 
-    workflow const& w = workflows.at(name);
+    workflow const& w = workflows.at(id);
     for (const rule& rule : w.rules) {
         const int v = part.at(category_to_dim(rule.cat));
         if ((rule.op == '<' && v < rule.value) || (rule.op == '>' && v > rule.value)) {
@@ -117,11 +155,11 @@ auto process_flows_recursive(std::string const& name, part const& part,
     return process_flows_recursive(w.fallback, part, workflows);
 }
 
-auto part1 = [](workflows_map const& workflows, std::vector<part> const& parts) -> i64
+auto part1 = [](input_t const& input) -> i64
 {
-    return flux::ref(parts)
+    return flux::ref(input.parts)
             .filter([&](part const& p) {
-                return process_flows_recursive("in", p, workflows);
+                return process_flows_recursive(input.start, p, input.workflows);
              })
             .map(flux::sum)
             .sum();
@@ -175,7 +213,7 @@ auto split_range(rule const& rule, part_range const& rng)
     }
 }
 
-auto part2 = [](workflows_map const& workflows) -> i64
+auto part2 = [](input_t const& input) -> i64
 {
     part_range initial_range = {{
         {.min = 1, .max = 4000},
@@ -184,21 +222,21 @@ auto part2 = [](workflows_map const& workflows) -> i64
         {.min = 1, .max = 4000}
     }};
 
-    std::vector<std::pair<std::string, part_range>> stack;
-    stack.emplace_back("in", initial_range);
+    std::vector<std::pair<id_type, part_range>> stack;
+    stack.emplace_back(input.start, initial_range);
 
     i64 count = 0;
 
     while (!stack.empty()) {
-        auto [name, rng] = stack.back();
+        auto [id, rng] = stack.back();
         stack.pop_back();
 
-        if (name == "A") {
+        if (id == accept) {
             count += flux::map(rng, [](auto r) -> i64 { return 1 + r.max - r.min; }).product();
-        } else if (name == "R") {
+        } else if (id == reject) {
             continue;
         } else {
-            workflow const& w = workflows.at(name);
+            workflow const& w = input.workflows.at(id);
             for (const rule& rule : w.rules) {
                 auto [accepted, rejected] = split_range(rule, rng);
                 stack.emplace_back(rule.dest, accepted);
@@ -230,22 +268,25 @@ hdj{m>838:A,pv}
 {x=2461,m=1339,a=466,s=291}
 {x=2127,m=1623,a=2188,s=1013})";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec19", solution);
+
+auto day_main(int argc, char** argv) -> int
 {
     {
-        auto const [workflows, parts] = parse_input(test_data);
-        assert(part1(workflows, parts) == 19114);
-        assert(part2(workflows) == 167409079868000);
+        auto const input = parse_input(test_data);
+        assert(part1(input) == 19114);
+        assert(part2(input) == 167409079868000);
     }
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec19", solution, argc, argv);
+}
 
-    auto const [workflows, parts] = parse_input(aoc::string_from_file(argv[1]));
-    fmt::println("Part 1: {}", part1(workflows, parts));
-    fmt::println("Part 2: {}", part2(workflows));
-}
\ No newline at end of file
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
+
+}
@@ -4,58 +4,72 @@
 #include <numeric>
 #include <queue>
 
-#include <ankerl/unordered_dense.h>
-
 namespace {
 
 enum class pulse_kind : bool { lo, hi };
 
+// Modules which are only ever sent pulses (and never listed themselves) are
+// untyped, and ignore them
 enum class module_kind {
-    flipflop, conjunction, broadcast
+    untyped, flipflop, conjunction, broadcast
 };
 
+using id_type = aoc::interner::id_type;
+
 struct module {
     template <typename Messenger>
-    void on_pulse(Messenger& m, pulse_kind p, std::string const& from)
+    void on_pulse(Messenger& m, pulse_kind p, id_type from)
     {
         if (kind == module_kind::flipflop) {
              if (p == pulse_kind::lo) {
                 if (!state) {
                     state = true;
-                    m.send(pulse_kind::hi, name, dests);
+                    m.send(pulse_kind::hi, id, dests);
                 } else {
                     state = false;
-                    m.send(pulse_kind::lo, name, dests);
+                    m.send(pulse_kind::lo, id, dests);
                 }
             }
         } else if (kind == module_kind::conjunction) {
-            inputs[from] = p;
-            if (flux::from_crange(inputs | std::views::values)
-                    .all(flux::pred::eq(pulse_kind::hi))) {
-                m.send(pulse_kind::lo, name, dests);
+            for (auto& [input, last] : inputs) {
+                if (input == from) {
+                    last = p;
+                }
+            }
+            if (flux::ref(inputs).all([](auto const& in) { return in.second == pulse_kind::hi; })) {
+                m.send(pulse_kind::lo, id, dests);
             } else {
-                m.send(pulse_kind::hi, name, dests);
+                m.send(pulse_kind::hi, id, dests);
             }
         } else if (kind == module_kind::broadcast) {
-            m.send(p, name, dests);
+            m.send(p, id, dests);
         }
     }
 
-    module_kind kind;
-    std::string name;
-    std::vector<std::string> dests;
+    module_kind kind = module_kind::untyped;
+    id_type id = 0;
+    std::vector<id_type> dests;
     bool state = false;
-    ankerl::unordered_dense::map<std::string, pulse_kind> inputs;
+    // The last pulse received from each input, for conjunctions
+    std::vector<std::pair<id_type, pulse_kind>> inputs;
 };
 
-using module_map = ankerl::unordered_dense::map<std::string, module>;
+// Modules are numbered as they're parsed, and kept in an array by number
+struct network {
+    std::vector<module> modules;
+    aoc::interner names;
+    id_type broadcaster;
+};
 
-auto parse_input = [](std::string_view input) -> module_map
+auto parse_input = [](std::string_view input) -> network
 {
-    module_map map =
-        flux::split_string(input, '\n')
+    network net;
+    // The button isn't a module, but it does send a pulse
+    net.names.intern("button");
+
+    aoc::line_index(input).lines()
         .filter(std::not_fn(flux::is_empty))
-        .map([](std::string_view line) -> std::pair<std::string, module> {
+        .for_each([&net](std::string_view line) {
             auto kind = [&] {
                 if (line[0] == '%') {
                     line.remove_prefix(1); return module_kind::flipflop;
@@ -66,45 +80,49 @@ auto parse_input = [](std::string_view input) -> module_map
                 }
             }();
 
-            auto mod = module{.kind = kind};
             auto arrow = line.find(" -> ");
-            mod.name = std::string(line.substr(0, arrow));
-            mod.dests = flux::split_string(line.substr(arrow + 4), ", ")
-                            .to<std::vector<std::string>>();
-            return {mod.name, std::move(mod)};
-        })
-        .to<module_map>();
-
-    // Let each module know about its inputs
-    for (auto const& [name, module] : map) {
-        for (std::string const& dest_name : module.dests) {
-            if (auto iter = map.find(dest_name); iter != map.end()) {
-                iter->second.inputs[name] = pulse_kind::lo;
-            }
+            auto const id = net.names.intern(line.substr(0, arrow));
+            auto dests = flux::split_string(line.substr(arrow + 4), ", ")
+                            .map([&net](std::string_view d) { return net.names.intern(d); })
+                            .to<std::vector>();
+            net.modules.resize(net.names.size());
+            net.modules[id].kind = kind;
+            net.modules[id].dests = std::move(dests);
+        });
+    net.modules.resize(net.names.size());
+    net.broadcaster = net.names.find("broadcaster").value();
+
+    // Let each module know its own number, and about its inputs
+    for (auto const i : flux::ints(0, flux::size(net.modules))) {
+        auto const id = static_cast<id_type>(i);
+        net.modules[id].id = id;
+        for (id_type dest : net.modules[id].dests) {
+            net.modules[dest].inputs.emplace_back(id, pulse_kind::lo);
         }
     }
 
-    return map;
+    return net;
 };
 
 struct messenger {
     struct message_info {
         pulse_kind p;
-        std::string sender;
-        std::string dest;
+        id_type sender;
+        id_type dest;
     };
 
-    void send(pulse_kind p, std::string const& sender,
-              std::vector<std::string> const& dests)
+    void send(pulse_kind p, id_type sender, std::vector<id_type> const& dests)
     {
-        for (const auto& d : dests) {
+        for (id_type d : dests) {
             msg_q.push({p, sender, d});
         }
     }
 
-    bool run(module_map& map, std::string const& target = "")
+    // Presses the button, returning whether target was sent a low pulse
+    bool run(network const& net, std::vector<module>& modules,
+             std::optional<id_type> target = std::nullopt)
     {
-        msg_q.push({pulse_kind::lo, "button", "broadcaster"});
+        msg_q.push({pulse_kind::lo, button, net.broadcaster});
         while (!msg_q.empty()) {
             auto info = msg_q.front();
             msg_q.pop();
@@ -119,38 +137,37 @@ struct messenger {
                 return true;
             }
 
-            if (!map.contains(info.dest)) {
-                continue;
-            }
-
-            map[info.dest].on_pulse(*this, info.p, info.sender);
+            modules[info.dest].on_pulse(*this, info.p, info.sender);
         }
         return false;
     }
 
+    static constexpr id_type button = 0;
+
     std::queue<message_info> msg_q;
     std::int64_t hi_count = 0;
     std::int64_t lo_count = 0;
 };
 
-auto part1 = [](module_map modules) -> std::int64_t
+auto part1 = [](network const& net) -> std::int64_t
 {
+    auto modules = net.modules;
     messenger m;
-    for (auto _ : flux::ints(0, 1000)) { m.run(modules); }
+    for (auto _ : flux::ints(0, 1000)) { m.run(net, modules); }
 
     return m.hi_count * m.lo_count;
 };
 
-auto part2 = [](module_map const& modules) -> int64_t
+auto part2 = [](network const& net) -> int64_t
 {
     std::vector<int64_t> values;
 
     // These are specific to my input, sorry about that
-    for (std::string name : {"nd", "pc", "vd", "tx"}) {
-        auto copy = modules;
+    for (std::string_view name : {"nd", "pc", "vd", "tx"}) {
+        auto modules = net.modules;
         messenger m;
         int counter = 1;
-        while (!m.run(copy, name)) {
+        while (!m.run(net, modules, net.names.find(name).value())) {
             ++counter;
         }
         values.push_back(counter);
@@ -173,22 +190,24 @@ R"(broadcaster -> a
 %b -> con
 &con -> output)";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec20", solution);
+
+auto day_main(int argc, char** argv) -> int
 {
     {
         assert(part1(parse_input(test_data1)) == 32000000);
-        assert(part2(parse_input(test_data2)) == 11687500);
+        assert(part1(parse_input(test_data2)) == 11687500);
     }
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec20", solution, argc, argv);
+}
 
-    auto input = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(input));
-    fmt::println("Part 2: {}", part2(input));
-}
\ No newline at end of file
+}
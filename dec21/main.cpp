@@ -1,97 +1,55 @@
 
 #include "../aoc.hpp"
 
-#include <set>
-
 namespace {
 
 using i64 = std::int64_t;
 
-struct vec2 {
-    i64 x, y;
-
-    friend constexpr auto operator+(vec2 a, vec2 b) -> vec2 {
-        return {a.x + b.x, a.y + b.y};
-    }
-
-    friend auto operator==(vec2, vec2) -> bool = default;
-    friend auto operator<=>(vec2, vec2) = default;
-};
-
-constexpr vec2 north{0, -1};
-constexpr vec2 east{1, 0};
-constexpr vec2 south{0, 1};
-constexpr vec2 west{-1, 0};
-
-struct grid2d {
-    std::string data;
-    i64 size; // assumed square
-
-    constexpr auto operator[](vec2 pos) const -> char
-    {
-        if (pos.x >= 0 && pos.x < size && pos.y >= 0 && pos.y < size) {
-            return data.at(pos.y * size + pos.x);
-        } else {
-            return '#';
-        }
-    }
-
-    constexpr auto tiled_at(vec2 pos) const -> char
-    {
-        pos.x %= size;
-        pos.y %= size;
-
-        if (pos.x < 0) {
-            pos.x += size;
-        }
-        if (pos.y < 0) {
-            pos.y += size;
-        }
+using grid_t = aoc::grid2d<char>;
 
-        return data.at(pos.y * size + pos.x);
-    }
-};
-
-auto parse_input = [](std::string_view input) -> grid2d
+auto parse_input = [](std::string_view input) -> grid_t
 {
-    return grid2d{
-        .data = flux::filter(input, flux::pred::neq('\n')).to<std::string>(),
-        .size = flux::find(input, '\n')
-    };
+    return grid_t::from_text(input, '#');
 };
 
+// Every step, the reachable plots are those next to a plot which was reachable
+// the step before. Keeping them in a bitgrid lets us take a step for 64 plots
+// at a time with shifts.
 template <bool Tiled>
-auto walk_garden = [](grid2d const& grid, i64 dist) -> i64
+auto walk_garden = [](grid_t const& grid, i64 dist) -> i64
 {
-    auto start_idx = flux::find(grid.data, 'S');
-    auto start_pos = vec2{start_idx % grid.size, start_idx / grid.size};
+    // For the infinite garden, lay out enough copies of the grid around the
+    // one we start in that we can never walk off the edge
+    i64 const tiles = Tiled ? 2 * (dist / std::min(grid.width(), grid.height()) + 1) + 1 : 1;
+
+    aoc::bitgrid plots(tiles * grid.width(), tiles * grid.height());
+    for (auto y : flux::ints(0, plots.height())) {
+        for (auto x : flux::ints(0, plots.width())) {
+            plots.set(x, y, grid.cell(x % grid.width(), y % grid.height()) != '#');
+        }
+    }
 
-    std::set<vec2> cur{start_pos};
+    auto const start_idx = grid.find('S');
+    aoc::bitgrid cur(plots.width(), plots.height());
+    cur.set(grid.x_of(start_idx) + tiles / 2 * grid.width(),
+            grid.y_of(start_idx) + tiles / 2 * grid.height());
 
     while (dist-- > 0) {
-        std::set<vec2> next;
-
-        for (vec2 pos : cur) {
-            for (vec2 off : {north, east, south, west}) {
-                if constexpr (Tiled) {
-                    if (grid.tiled_at(pos + off) != '#') {
-                        next.insert(pos + off);
-                    }
-                } else {
-                    if (grid[pos + off] != '#') {
-                        next.insert(pos + off);
-                    }
-                }
-            }
+        auto next = cur;
+        next.shift_north();
+        for (auto shift : {&aoc::bitgrid::shift_east, &aoc::bitgrid::shift_south,
+                           &aoc::bitgrid::shift_west}) {
+            auto moved = cur;
+            next |= (moved.*shift)();
         }
-
+        next &= plots;
         cur = std::move(next);
     }
 
-    return cur.size();
+    return cur.count();
 };
 
-auto part1 = [](grid2d const& grid, i64 dist) -> i64
+auto part1 = [](grid_t const& grid, i64 dist) -> i64
 {
     return walk_garden<false>(grid, dist);
 };
@@ -99,7 +57,7 @@ auto part1 = [](grid2d const& grid, i64 dist) -> i64
 // This is stolen wholesale from
 // https://github.com/apprenticewiz/adventofcode/blob/main/2023/rust/day21b/src/main.rs
 // (including the comment below)
-auto part2 = [](grid2d const& grid) -> i64
+auto part2 = [](grid_t const& grid) -> i64
 {
     auto b0 = walk_garden<true>(grid, 65);
     auto b1 = walk_garden<true>(grid, 196);
@@ -137,28 +95,30 @@ R"(...........
 .##..##.##.
 ...........)";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = [](grid_t const& grid) { return part1(grid, 64); },
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec21", solution, 5);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
     {
-        grid2d const test_grid = parse_input(test_data);
+        grid_t const test_grid = parse_input(test_data);
         assert(part1(parse_input(test_data), 6) == 16);
 
         assert(walk_garden<true>(test_grid, 6) == 16);
         assert(walk_garden<true>(test_grid, 10) == 50);
         assert(walk_garden<true>(test_grid, 50) == 1594);
         assert(walk_garden<true>(test_grid, 100) == 6536);
-//        assert(walk_garden<true>(test_grid, 500) == 167004);
+        assert(walk_garden<true>(test_grid, 500) == 167004);
     }
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec21", solution, argc, argv);
+}
 
-    grid2d const grid = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(grid, 64));
-    fmt::println("Part 2: {}", part2(grid));
-}
\ No newline at end of file
+}
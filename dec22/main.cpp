@@ -17,12 +17,12 @@ struct brick_t {
 auto parse_input = [](std::string_view input) -> std::vector<brick_t>
 {
     auto to_vec3 = [](std::string_view str) -> vec3 {
-        vec3 out;
-        flux::split_string(str, ',').map(aoc::parse<int>).output_to(out.begin());
+        vec3 out{};
+        aoc::parse_all<int>(str, out.begin());
         return out;
     };
 
-    return flux::split_string(input, '\n')
+    return aoc::line_index(input).lines()
             .filter(std::not_fn(flux::is_empty))
             .map([&](std::string_view line) -> brick_t {
                 auto tilde = line.find('~');
@@ -152,9 +152,22 @@ R"(1,0,1~1,2,1
 0,1,6~2,1,6
 1,1,8~1,1,9)";
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = [](std::string_view input) {
+        auto bricks = parse_input(input);
+        {
+            aoc::phase p("prepare_bricks");
+            prepare_bricks(bricks);
+        }
+        return bricks;
+    },
+    .part1 = part1,
+    .part2 = part2
+};
 
-int main(int argc, char** argv)
+[[maybe_unused]] bool const registered = aoc::register_day("dec22", solution, 10);
+
+auto day_main(int argc, char** argv) -> int
 {
     {
         auto bricks = parse_input(test_data);
@@ -163,14 +176,9 @@ int main(int argc, char** argv)
         fmt::println("Part 2 test: {}", part2(bricks));
     }
 
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec22", solution, argc, argv);
+}
 
-    auto bricks = parse_input(aoc::string_from_file(argv[1]));
-    prepare_bricks(bricks);
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(bricks));
-    fmt::println("Part 2: {}", part2(bricks));
 }
@@ -51,25 +51,18 @@ struct hailstone {
 };
 
 auto parse_vec3 = [](std::string_view str) -> dvec3 {
-    auto seq =  flux::split_string(str, ',')
-                   .filter(std::not_fn(flux::is_empty))
-                   .map(aoc::parse<i64>);
-    auto pos = seq.first();
-    return dvec3{
-        .x = double(seq[pos]), .y = double(seq[seq.inc(pos)]), .z = double(seq[seq.inc(pos)])
-    };
+    std::array<i64, 3> v{};
+    aoc::parse_all<i64>(str, v.begin());
+    return dvec3{.x = double(v[0]), .y = double(v[1]), .z = double(v[2])};
 };
 
 auto parse_input = [](std::string_view input) -> std::vector<hailstone>
 {
-    return flux::split_string(input, '\n')
-            .filter(std::not_fn(flux::is_empty))
-            .map([](std::string_view line) -> hailstone {
-                auto at = line.find('@');
-                return {.position = parse_vec3(line.substr(0, at - 1)),
-                        .velocity = parse_vec3(line.substr(at + 1))};
-            })
-            .to<std::vector>();
+    return aoc::parse_lines(input, [](std::string_view line) -> hailstone {
+        auto at = line.find('@');
+        return {.position = parse_vec3(line.substr(0, at - 1)),
+                .velocity = parse_vec3(line.substr(at + 1))};
+    });
 };
 
 template <i64 Min, i64 Max>
@@ -154,17 +147,19 @@ static_assert([]{
            part2(stones) == 47;
 }());
 
-}
+constexpr auto solution = aoc::solution{
+    .parse = parse_input,
+    .part1 = part1,
+    .part2 = part2
+};
+
+[[maybe_unused]] bool const registered = aoc::register_day("dec24", solution);
 
-int main(int argc, char** argv)
+auto day_main(int argc, char** argv) -> int
 {
-    if (argc < 2) {
-        fmt::println(stderr, "No input");
-        return -1;
-    }
+    return aoc::run("dec24", solution, argc, argv);
+}
 
-    auto const stones = parse_input(aoc::string_from_file(argv[1]));
+[[maybe_unused]] bool const registered_main = aoc::register_main(day_main);
 
-    fmt::println("Part 1: {}", part1(stones));
-    fmt::println("Part 2: {}", part2(stones));
-}
\ No newline at end of file
+}